@@ -0,0 +1,598 @@
+// Micro benchmarks of the Canvas API on a null NanoVG backend, no GPU is needed.
+//
+// Build it together with the NanoVG sources, for example:
+//
+//   cc  -O2 -c nanovg/src/nanovg.c -o nanovg.o
+//   c++ -O2 -std=c++11 -Isrc -Inanovg/src bench/CanvasBench.cpp src/*.cpp nanovg.o -o canvasbench
+//
+// Run it with a TrueType font to include the text benchmarks:
+//
+//   ./canvasbench nanovg/example/Roboto-Regular.ttf
+//
+// It exits with 1 if the SIMD and scalar color conversions differ or a steady frame
+// touches the heap.
+#include "NanoCanvas.h"
+#include "nanovg.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+
+using namespace NanoCanvas;
+
+/// The count of heap allocations made by the process
+static unsigned long long g_allocations = 0ULL;
+
+void* operator new(std::size_t size)
+{
+    ++g_allocations;
+    void* p = std::malloc(size ? size : 1);
+    if( !p )
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    /// Render calls received by the null backend
+    struct NullBackend
+    {
+        long fills     = 0;
+        long strokes   = 0;
+        long triangles = 0;
+    };
+
+    int nullCreate(void* ){ return 1; }
+    int nullCreateTexture(void* ,int ,int ,int ,int ,const unsigned char* ){ return 1; }
+    int nullDeleteTexture(void* ,int ){ return 1; }
+    int nullUpdateTexture(void* ,int ,int ,int ,int ,int ,const unsigned char* ){ return 1; }
+    int nullGetTextureSize(void* ,int ,int* w,int* h){ *w = *h = 64; return 1; }
+    void nullViewport(void* ,float ,float ,float ){}
+    void nullCancel(void* ){}
+    void nullFlush(void* ){}
+    void nullFill(void* uptr,NVGpaint* ,NVGcompositeOperationState ,NVGscissor* ,
+                  float ,const float* ,const NVGpath* ,int )
+    {
+        ((NullBackend*)uptr)->fills++;
+    }
+    void nullStroke(void* uptr,NVGpaint* ,NVGcompositeOperationState ,NVGscissor* ,
+                    float ,float ,const NVGpath* ,int )
+    {
+        ((NullBackend*)uptr)->strokes++;
+    }
+    void nullTriangles(void* uptr,NVGpaint* ,NVGcompositeOperationState ,NVGscissor* ,
+                       const NVGvertex* ,int ,float )
+    {
+        ((NullBackend*)uptr)->triangles++;
+    }
+    void nullDelete(void* ){}
+
+    /// Create a NanoVG context which drops all the render calls
+    NVGcontext* createNullContext(NullBackend* backend)
+    {
+        NVGparams params;
+        std::memset(&params,0,sizeof(params));
+        params.userPtr = backend;
+        params.edgeAntiAlias = 1;
+        params.renderCreate = nullCreate;
+        params.renderCreateTexture = nullCreateTexture;
+        params.renderDeleteTexture = nullDeleteTexture;
+        params.renderUpdateTexture = nullUpdateTexture;
+        params.renderGetTextureSize = nullGetTextureSize;
+        params.renderViewport = nullViewport;
+        params.renderCancel = nullCancel;
+        params.renderFlush = nullFlush;
+        params.renderFill = nullFill;
+        params.renderStroke = nullStroke;
+        params.renderTriangles = nullTriangles;
+        params.renderDelete = nullDelete;
+        return nvgCreateInternal(&params);
+    }
+
+    /**
+     * @brief Run a benchmark body and print the time and heap allocations per operation
+     * @param name The name of the benchmark
+     * @param ops The count of operations done by one run of the body
+     * @param runs How many times to run the body
+     * @return The time per operation in nanoseconds
+     */
+    template<typename Body>
+    double run(const char* name,long ops,int runs,Body body)
+    {
+        body(); // warm up
+        unsigned long long allocations = g_allocations;
+        auto start = std::chrono::steady_clock::now();
+        for( int i = 0 ; i < runs ; ++i )
+            body();
+        auto end = std::chrono::steady_clock::now();
+        allocations = g_allocations - allocations;
+        double ns = std::chrono::duration<double,std::nano>(end - start).count();
+        double perOp = ns / ((double)ops * runs);
+        std::printf("%-32s %10.1f ns/op %8.3f allocs/op\n",name,perOp,
+                    (double)allocations / ((double)ops * runs));
+        return perOp;
+    }
+
+    /// Keep a computed value from being optimized out
+    volatile unsigned g_sink = 0U;
+}
+
+int main(int argc,char** argv)
+{
+    NullBackend backend;
+    NVGcontext* vg = createNullContext(&backend);
+    if( !vg )
+    {
+        std::fprintf(stderr,"Failed to create NanoVG context\n");
+        return 1;
+    }
+    Canvas canvas(vg,1920,1080);
+
+/*------------------- Rectangle batches -------------------*/
+
+    const size_t rectCount = 50000;
+    std::vector<float> rects(rectCount*4);
+    std::vector<Color> colors(rectCount);
+    for( size_t i = 0 ; i < rectCount ; ++i )
+    {
+        rects[i*4]   = (float)(i % 250) * 7.0f;
+        rects[i*4+1] = (float)(i / 250) * 5.0f;
+        rects[i*4+2] = 6.0f;
+        rects[i*4+3] = 4.0f;
+        colors[i] = (i / 1000) % 2 ? Colors::SteelBlue : Colors::Salmon;
+    }
+
+    auto frame = [&](const std::function<void()>& draw)
+    {
+        return [&canvas,draw]()
+        {
+            canvas.begineFrame(1920,1080);
+            draw();
+            canvas.endFrame();
+        };
+    };
+
+    backend = NullBackend();
+    double loop = run("fillRect x50k",rectCount,10,frame([&]()
+    {
+        canvas.fillStyle(Colors::Salmon);
+        for( size_t i = 0 ; i < rectCount ; ++i )
+            canvas.fillRect(rects[i*4],rects[i*4+1],rects[i*4+2],rects[i*4+3]);
+    }));
+    long loopFills = backend.fills / 11;
+
+    backend = NullBackend();
+    double batch = run("fillRects x50k",rectCount,10,frame([&]()
+    {
+        canvas.fillStyle(Colors::Salmon).fillRects(rects.data(),rectCount);
+    }));
+    long batchFills = backend.fills / 11;
+
+    backend = NullBackend();
+    run("fillRects colored x50k",rectCount,10,frame([&]()
+    {
+        canvas.fillRects(rects.data(),colors.data(),rectCount);
+    }));
+    long coloredFills = backend.fills / 11;
+
+    run("strokeRects x50k",rectCount,10,frame([&]()
+    {
+        canvas.strokeStyle(Colors::Black).strokeRects(rects.data(),rectCount);
+    }));
+
+    std::printf("fillRects speedup over fillRect loop: %.2fx\n",loop / batch);
+    std::printf("backend fills per frame: loop %ld, batch %ld, colored batch %ld\n",
+                loopFills,batchFills,coloredFills);
+
+/*------------------- Hit testing -------------------*/
+
+    double indexed = run("fillRect+setHitID x50k",rectCount,10,frame([&]()
+    {
+        canvas.fillStyle(Colors::Salmon);
+        for( size_t i = 0 ; i < rectCount ; ++i )
+            canvas.setHitID((unsigned)i + 1).fillRect(rects[i*4],rects[i*4+1],rects[i*4+2],rects[i*4+3]);
+        canvas.setHitID(0);
+    }));
+    std::printf("hit recording overhead: %.2fx\n",indexed / loop);
+
+    // The grid keeps the shapes of the last frame
+    const long queryCount = 100000;
+    run("hitTest x100k",queryCount,10,[&]()
+    {
+        unsigned found = 0;
+        for( long i = 0 ; i < queryCount ; ++i )
+            found += canvas.hitTest((float)(i*7 % 1920),(float)(i*13 % 1080)) != 0;
+        g_sink = found;
+    });
+
+    Path2D ring;
+    ring.circle(0,0,50).circle(0,0,20).pathWinding(Canvas::Winding::CW);
+    run("isPointInPath(Path2D) x100k",queryCount,10,[&]()
+    {
+        unsigned found = 0;
+        for( long i = 0 ; i < queryCount ; ++i )
+            found += canvas.isPointInPath(ring,(float)(i % 120) - 60.0f,(float)(i / 120 % 120) - 60.0f);
+        g_sink = found;
+    });
+
+/*------------------- Sprite batches -------------------*/
+
+    const size_t spriteCount = 10000;
+    std::vector<unsigned char> texels(64*64*4,255);
+    Memery texelMem;
+    texelMem.data = texels.data();
+    texelMem.size = texels.size();
+    Image atlas(canvas,64,64,texelMem);
+    std::vector<float> spriteSrc(spriteCount*4);
+    std::vector<float> spriteDst(spriteCount*4);
+    for( size_t i = 0 ; i < spriteCount ; ++i )
+    {
+        spriteSrc[i*4]   = (float)(i % 4) * 16.0f;
+        spriteSrc[i*4+1] = (float)(i / 4 % 4) * 16.0f;
+        spriteSrc[i*4+2] = spriteSrc[i*4+3] = 16.0f;
+        spriteDst[i*4]   = (float)(i % 100) * 19.0f;
+        spriteDst[i*4+1] = (float)(i / 100) * 10.0f;
+        spriteDst[i*4+2] = spriteDst[i*4+3] = 16.0f;
+    }
+
+    double single = run("drawImage x10k",spriteCount,10,frame([&]()
+    {
+        for( size_t i = 0 ; i < spriteCount ; ++i )
+        {
+            const float* s = &spriteSrc[i*4];
+            const float* d = &spriteDst[i*4];
+            canvas.drawImage(atlas,d[0],d[1],d[2],d[3],s[0],s[1],s[2],s[3]);
+        }
+    }));
+    double sprites = run("drawImages x10k",spriteCount,10,frame([&]()
+    {
+        canvas.drawImages(atlas,spriteSrc.data(),spriteDst.data(),spriteCount);
+    }));
+    std::printf("drawImages speedup over drawImage loop: %.2fx\n",single / sprites);
+
+/*------------------- Paths -------------------*/
+
+    const long pathCount = 10000;
+    run("path build+fill x10k",pathCount,10,frame([&]()
+    {
+        for( long i = 0 ; i < pathCount ; ++i )
+        {
+            float x = (float)(i % 100) * 19.0f;
+            float y = (float)(i / 100) * 10.0f;
+            canvas.beginPath()
+                  .moveTo(x,y)
+                  .lineTo(x + 10,y)
+                  .quadraticCurveTo(x + 15,y + 5,x + 10,y + 10)
+                  .bezierCurveTo(x + 5,y + 15,x,y + 12,x,y + 10)
+                  .closePath()
+                  .fill();
+        }
+    }));
+    run("roundedRect stroke x10k",pathCount,10,frame([&]()
+    {
+        for( long i = 0 ; i < pathCount ; ++i )
+            canvas.beginPath()
+                  .roundedRect((float)(i % 100) * 19.0f,(float)(i / 100) * 10.0f,16,8,3)
+                  .stroke();
+    }));
+    run("arc fill x10k",pathCount,10,frame([&]()
+    {
+        for( long i = 0 ; i < pathCount ; ++i )
+            canvas.beginPath()
+                  .arc((float)(i % 100) * 19.0f,(float)(i / 100) * 10.0f,5,0,(float)PI*1.5f)
+                  .fill();
+    }));
+    Path2D star;
+    star.moveTo(0,-8);
+    for( int i = 1 ; i < 10 ; ++i )
+    {
+        float r = i % 2 ? 3.0f : 8.0f;
+        float angle = (float)PI * i / 5.0f;
+        star.lineTo(r*std::sin(angle),-r*std::cos(angle));
+    }
+    star.closePath();
+    run("Path2D fill x10k",pathCount,10,frame([&]()
+    {
+        for( long i = 0 ; i < pathCount ; ++i )
+        {
+            canvas.save()
+                  .translate((float)(i % 100) * 19.0f,(float)(i / 100) * 10.0f)
+                  .fill(star)
+                  .restore();
+        }
+    }));
+
+/*------------------- Style setters -------------------*/
+
+    const long setterCount = 100000;
+    run("fillStyle(Color) changed",setterCount,10,frame([&]()
+    {
+        for( long i = 0 ; i < setterCount ; ++i )
+            canvas.fillStyle(i % 2 ? Colors::Salmon : Colors::SteelBlue);
+    }));
+    run("fillStyle(Color) redundant",setterCount,10,frame([&]()
+    {
+        for( long i = 0 ; i < setterCount ; ++i )
+            canvas.fillStyle(Colors::Salmon);
+    }));
+    run("lineWidth+globalAlpha",setterCount,10,frame([&]()
+    {
+        for( long i = 0 ; i < setterCount ; ++i )
+            canvas.lineWidth(1.0f + (i % 3)).globalAlpha(i % 2 ? 0.5f : 1.0f);
+    }));
+    run("save+restore",setterCount,10,frame([&]()
+    {
+        for( long i = 0 ; i < setterCount ; ++i )
+            canvas.save().restore();
+    }));
+    Paint gradient = Canvas::createLinearGradient(0,0,100,0,Colors::Salmon,Colors::SteelBlue);
+    run("fillStyle(Paint) gradient",setterCount,10,frame([&]()
+    {
+        for( long i = 0 ; i < setterCount ; ++i )
+            canvas.fillStyle(gradient);
+    }));
+    CompiledPaint compiled = canvas.compilePaint(gradient);
+    run("fillStyle(CompiledPaint)",setterCount,10,frame([&]()
+    {
+        for( long i = 0 ; i < setterCount ; ++i )
+            canvas.fillStyle(compiled);
+    }));
+
+/*------------------- Text -------------------*/
+
+    Font font;
+    if( argc > 1 )
+        font = Font(canvas,"bench",argv[1]);
+    if( font.valid() )
+    {
+        const long textCount = 10000;
+        const string label = "Throughput 1234.56 ms";
+        TextStyle style;
+        style.face = font.face;
+        style.size = 14.0f;
+        style.color = Colors::Black;
+        TextLayout layout(label,style);
+        run("fillText(string) x10k",textCount,10,frame([&]()
+        {
+            canvas.fillStyle(style);
+            for( long i = 0 ; i < textCount ; ++i )
+                canvas.fillText(label,(float)(i % 10) * 190.0f,(float)(i / 10) + 14.0f);
+        }));
+        run("fillText(const char*) x10k",textCount,10,frame([&]()
+        {
+            canvas.fillStyle(style);
+            for( long i = 0 ; i < textCount ; ++i )
+                canvas.fillText("Throughput 1234.56 ms",(float)(i % 10) * 190.0f,(float)(i / 10) + 14.0f);
+        }));
+        run("fillText(TextLayout) x10k",textCount,10,frame([&]()
+        {
+            for( long i = 0 ; i < textCount ; ++i )
+                canvas.fillText(layout,(float)(i % 10) * 190.0f,(float)(i / 10) + 14.0f);
+        }));
+        // A column of live prices, right aligned
+        const long priceCount = 5000;
+        TextStyle prices = style;
+        prices.hAlign = TextAlign::Right;
+        NumberFormat money;
+        money.precision = 2;
+        money.thousands = ',';
+        run("fillText(std::to_string) x5k",priceCount,10,frame([&]()
+        {
+            canvas.fillStyle(prices);
+            for( long i = 0 ; i < priceCount ; ++i )
+                canvas.fillText(std::to_string(1000.0 + i*0.37),1800.0f,(float)(i % 70)*15.0f + 14.0f);
+        }));
+        run("fillNumber x5k",priceCount,10,frame([&]()
+        {
+            canvas.fillStyle(prices);
+            for( long i = 0 ; i < priceCount ; ++i )
+                canvas.fillNumber(1000.0 + i*0.37,money,1800.0f,(float)(i % 70)*15.0f + 14.0f);
+        }));
+        run("measureText(string) x10k",textCount,10,frame([&]()
+        {
+            canvas.fillStyle(style);
+            float width = 0;
+            for( long i = 0 ; i < textCount ; ++i )
+                width += canvas.measureText(label);
+            g_sink = (unsigned)width;
+        }));
+        run("measureText(TextLayout) x10k",textCount,10,frame([&]()
+        {
+            float width = 0;
+            for( long i = 0 ; i < textCount ; ++i )
+                width += canvas.measureText(layout);
+            g_sink = (unsigned)width;
+        }));
+    }
+    else
+        std::printf("text benchmarks skipped, pass the path of a TrueType font to run them\n");
+
+/*------------------- Color math -------------------*/
+
+    const long colorCount = 1000000;
+    run("Color from floats",colorCount,10,[&]()
+    {
+        unsigned code = 0U;
+        for( long i = 0 ; i < colorCount ; ++i )
+        {
+            float f = (float)(i & 255) / 255.0f;
+            code += Color(f,1.0f - f,0.5f,1.0f).code();
+        }
+        g_sink = code;
+    });
+    run("Color add+multiply",colorCount,10,[&]()
+    {
+        Color sum;
+        Color tint(0.9f,0.8f,0.7f,1.0f);
+        for( long i = 0 ; i < colorCount ; ++i )
+        {
+            Color c((unsigned)i*2654435761U);
+            sum += c * tint;
+        }
+        g_sink = sum.code();
+    });
+    run("Color::createWidthHSL",colorCount,10,[&]()
+    {
+        unsigned code = 0U;
+        for( long i = 0 ; i < colorCount ; ++i )
+            code += Color::createWidthHSL((float)(i % 360) / 360.0f,0.6f,0.5f).code();
+        g_sink = code;
+    });
+
+    std::vector<float> hues(colorCount),sats(colorCount),lights(colorCount);
+    for( long i = 0 ; i < colorCount ; ++i )
+    {
+        hues[i] = (float)(i % 997) / 997.0f;
+        sats[i] = 0.3f + (float)(i % 7) * 0.1f;
+        lights[i] = 0.2f + (float)(i % 13) * 0.05f;
+    }
+    std::vector<Color> heatmap(colorCount);
+    double perColor = run("hslToRgb per color",colorCount,10,[&]()
+    {
+        for( long i = 0 ; i < colorCount ; ++i )
+        {
+            ColorConverter::hslToRgb(hues[i],sats[i],lights[i],heatmap[i].mem);
+            heatmap[i].a = 255;
+        }
+    });
+    std::vector<Color> batched(colorCount);
+    double batchColor = run("hslToRgba batch",colorCount,10,[&]()
+    {
+        ColorConverter::hslToRgba(hues.data(),sats.data(),lights.data(),nullptr,
+                                  colorCount,(ColorConverter::byte*)batched.data());
+    });
+    int maxError = 0;
+    for( long i = 0 ; i < colorCount ; ++i )
+        for( int c = 0 ; c < 4 ; ++c )
+            maxError = std::max(maxError,std::abs((int)heatmap[i][c] - (int)batched[i][c]));
+    std::printf("hslToRgba speedup over hslToRgb: %.2fx, max channel difference %d\n",
+                perColor / batchColor,maxError);
+    run("rgbaToHsl batch",colorCount,10,[&]()
+    {
+        ColorConverter::rgbaToHsl((const ColorConverter::byte*)batched.data(),colorCount,
+                                  hues.data(),sats.data(),lights.data());
+    });
+
+    // Batches of less than four colors run the scalar code, both paths must give the same bits
+    // for random HSL and HSV values and for all the RGB colors
+    const size_t checkCount = 1 << 16;
+    std::vector<float> checkIn[4],simdOut[3],scalarOut[3];
+    for( auto& values : checkIn )
+        values.resize(checkCount);
+    for( int k = 0 ; k < 3 ; ++k )
+    {
+        simdOut[k].resize(checkCount);
+        scalarOut[k].resize(checkCount);
+    }
+    std::vector<ColorConverter::byte> rgbaIn(checkCount*4),simdRgba(checkCount*4),scalarRgba(checkCount*4);
+    int simdMismatches = 0;
+    auto compare = [&](const char* name,const void* simd,const void* scalar,size_t bytes)
+    {
+        if( std::memcmp(simd,scalar,bytes) )
+        {
+            std::fprintf(stderr,"FAILED: %s gives different SIMD and scalar results\n",name);
+            ++simdMismatches;
+        }
+    };
+    std::mt19937 random(20240501U);
+    // Hues out of [0, 1] wrap, the other values out of it are clamped
+    std::uniform_real_distribution<float> hueRange(-4.0f,4.0f),channelRange(-0.25f,1.25f);
+    for( int chunk = 0 ; chunk < 16 && !simdMismatches ; ++chunk )
+    {
+        for( size_t i = 0 ; i < checkCount ; ++i )
+        {
+            checkIn[0][i] = hueRange(random);
+            checkIn[1][i] = channelRange(random);
+            checkIn[2][i] = channelRange(random);
+            checkIn[3][i] = channelRange(random);
+        }
+        ColorConverter::hslToRgba(checkIn[0].data(),checkIn[1].data(),checkIn[2].data(),checkIn[3].data(),
+                                  checkCount,simdRgba.data());
+        for( size_t i = 0 ; i < checkCount ; ++i )
+            ColorConverter::hslToRgba(&checkIn[0][i],&checkIn[1][i],&checkIn[2][i],&checkIn[3][i],
+                                      1,&scalarRgba[i*4]);
+        compare("hslToRgba",simdRgba.data(),scalarRgba.data(),simdRgba.size());
+        ColorConverter::hsvToRgba(checkIn[0].data(),checkIn[1].data(),checkIn[2].data(),checkIn[3].data(),
+                                  checkCount,simdRgba.data());
+        for( size_t i = 0 ; i < checkCount ; ++i )
+            ColorConverter::hsvToRgba(&checkIn[0][i],&checkIn[1][i],&checkIn[2][i],&checkIn[3][i],
+                                      1,&scalarRgba[i*4]);
+        compare("hsvToRgba",simdRgba.data(),scalarRgba.data(),simdRgba.size());
+    }
+    for( size_t first = 0 ; first < ( 1 << 24 ) && !simdMismatches ; first += checkCount )
+    {
+        for( size_t i = 0 ; i < checkCount ; ++i )
+        {
+            size_t rgb = first + i;
+            ColorConverter::byte* rgba = &rgbaIn[i*4];
+            rgba[0] = (ColorConverter::byte)( rgb >> 16 );
+            rgba[1] = (ColorConverter::byte)( rgb >> 8 );
+            rgba[2] = (ColorConverter::byte)rgb;
+            rgba[3] = 255;
+        }
+        ColorConverter::rgbaToHsl(rgbaIn.data(),checkCount,simdOut[0].data(),simdOut[1].data(),simdOut[2].data());
+        for( size_t i = 0 ; i < checkCount ; ++i )
+            ColorConverter::rgbaToHsl(&rgbaIn[i*4],1,&scalarOut[0][i],&scalarOut[1][i],&scalarOut[2][i]);
+        for( int k = 0 ; k < 3 ; ++k )
+            compare("rgbaToHsl",simdOut[k].data(),scalarOut[k].data(),checkCount*sizeof(float));
+        ColorConverter::rgbaToHsv(rgbaIn.data(),checkCount,simdOut[0].data(),simdOut[1].data(),simdOut[2].data());
+        for( size_t i = 0 ; i < checkCount ; ++i )
+            ColorConverter::rgbaToHsv(&rgbaIn[i*4],1,&scalarOut[0][i],&scalarOut[1][i],&scalarOut[2][i]);
+        for( int k = 0 ; k < 3 ; ++k )
+            compare("rgbaToHsv",simdOut[k].data(),scalarOut[k].data(),checkCount*sizeof(float));
+    }
+    std::printf("SIMD and scalar color conversions: %s\n",simdMismatches ? "different" : "identical");
+
+/*------------------- Steady frames -------------------*/
+
+    // A frame drawing the same scene as the previous one should not touch the heap
+    Paint ramp = Canvas::createLinearGradient(0,0,0,400);
+    ramp.addColorStop(0.0f,Colors::White)
+        .addColorStop(0.5f,Colors::SteelBlue)
+        .addColorStop(1.0f,Colors::Black);
+    TextStyle label;
+    label.face = font.face;
+    label.size = 12.0f;
+    label.color = Colors::White;
+    TextLayout title("Steady frame",label);
+    auto scene = [&]()
+    {
+        canvas.begineFrame(1920,1080);
+        canvas.clearColor(Colors::DarkSlateGray);
+        canvas.fillStyle(ramp).fillRects(rects.data(),1000);
+        canvas.fillRects(rects.data() + 4000,colors.data() + 1000,1000);
+        canvas.drawImages(atlas,spriteSrc.data(),spriteDst.data(),100);
+        canvas.save().translate(200,200).fill(star).restore();
+        canvas.beginPath().arc(300,300,50,0,(float)PI).stroke();
+        if( font.valid() )
+        {
+            canvas.fillStyle(label).fillText("FPS 60",10,20);
+            canvas.fillText(title,10,40);
+        }
+        canvas.invalidate(0,0,100,100);
+        canvas.repaint([&](Canvas& c){ c.fillStyle(Colors::Red).fillRect(0,0,100,100); });
+        canvas.endFrame();
+    };
+    for( int i = 0 ; i < 3 ; ++i )
+        scene();
+    const int steadyFrames = 100;
+    unsigned long long before = g_allocations;
+    for( int i = 0 ; i < steadyFrames ; ++i )
+        scene();
+    unsigned long long steadyAllocations = g_allocations - before;
+    std::printf("steady frame allocations: %.2f per frame%s\n",
+                (double)steadyAllocations / steadyFrames,
+                font.valid() ? "" : " (without text)");
+
+    nvgDeleteInternal(vg);
+    if( steadyAllocations )
+        std::fprintf(stderr,"FAILED: the steady frame allocates\n");
+    return steadyAllocations || simdMismatches ? 1 : 0;
+}
@@ -1,5 +1,7 @@
 #include "NanoCanvas.h"
 #include "nanovg.h"
+#include <cstring>
+#include <atomic>
 
 namespace NanoCanvas
 {
@@ -22,9 +24,20 @@ namespace NanoCanvas
                 float y1 = paint.bb;
                 canvas.local2Global(x0,y0);
                 canvas.local2Global(x1,y1);
-                nvgPaint = nvgLinearGradient(canvas.nvgContext(),x0,y0,x1,y1,
-                                             nvgColor(paint.sColor),
-                                             nvgColor(paint.eColor));
+                int ramp = canvas.gradientImage(paint);
+                if( ramp )
+                {
+                    // Stretch the ramp along the gradient line, its edges extend beyond the ends
+                    float dx = x1 - x0;
+                    float dy = y1 - y0;
+                    float length = std::max(std::sqrt(dx*dx + dy*dy),1e-4f);
+                    nvgPaint = nvgImagePattern(canvas.nvgContext(),x0,y0,length,1.0f,
+                                               std::atan2(dy,dx),ramp,1.0f);
+                }
+                else
+                    nvgPaint = nvgLinearGradient(canvas.nvgContext(),x0,y0,x1,y1,
+                                                 nvgColor(paint.sColor),
+                                                 nvgColor(paint.eColor));
             }
             break;
             case Paint::Type::Box:
@@ -43,10 +56,19 @@ namespace NanoCanvas
                 float cx = paint.xx;
                 float cy = paint.yy;
                 canvas.local2Global(cx,cy);
-                nvgPaint = nvgRadialGradient(canvas.nvgContext(),cx,cy,
-                                             paint.aa,paint.bb,
-                                             nvgColor(paint.sColor),
-                                             nvgColor(paint.eColor));
+                int disc = canvas.gradientImage(paint);
+                if( disc )
+                {
+                    // The disc texture covers the larger circle
+                    float r = std::max(std::max(paint.aa,paint.bb),1e-4f);
+                    nvgPaint = nvgImagePattern(canvas.nvgContext(),cx - r,cy - r,r*2,r*2,
+                                               0.0f,disc,1.0f);
+                }
+                else
+                    nvgPaint = nvgRadialGradient(canvas.nvgContext(),cx,cy,
+                                                 paint.aa,paint.bb,
+                                                 nvgColor(paint.sColor),
+                                                 nvgColor(paint.eColor));
             }
             break;
             case Paint::Type::ImagePattern:
@@ -78,12 +100,23 @@ namespace NanoCanvas
         m_xPos  = m_yPos = 0;
     }
 
+    Canvas::~Canvas()
+    {
+        if( m_nvgCtx )
+        {
+            for( auto& gradient : m_gradientImages.entries )
+                nvgDeleteImage(m_nvgCtx,gradient.image);
+            deleteRetiredGradients();
+        }
+    }
+
 
 /*-------------------- Style Control -------------------*/
 
     Canvas& Canvas::globalAlpha(float alpha)
     {
-        nvgGlobalAlpha(m_nvgCtx,alpha);
+        if( changeState(RenderState::Alpha,m_state.alpha,alpha) )
+            nvgGlobalAlpha(m_nvgCtx,alpha);
         return *this;
     }
 
@@ -94,7 +127,8 @@ namespace NanoCanvas
             nvgCap = NVG_SQUARE;
         else if ( cap == LineCap::ROUND)
             nvgCap = NVG_ROUND;
-        nvgLineCap(m_nvgCtx,nvgCap);
+        if( changeState(RenderState::LineCap,m_state.lineCap,nvgCap) )
+            nvgLineCap(m_nvgCtx,nvgCap);
         return *this;
     }
 
@@ -105,26 +139,30 @@ namespace NanoCanvas
             nvgJoin = NVG_ROUND;
         else if ( join == LineJoin::MITER)
             nvgJoin = NVG_MITER;
-        nvgLineJoin(m_nvgCtx,nvgJoin);
+        if( changeState(RenderState::LineJoin,m_state.lineJoin,nvgJoin) )
+            nvgLineJoin(m_nvgCtx,nvgJoin);
         return *this;
     }
 
     Canvas& Canvas::lineWidth(float width)
     {
-        nvgStrokeWidth(m_nvgCtx,width);
+        if( changeState(RenderState::LineWidth,m_state.lineWidth,width) )
+            nvgStrokeWidth(m_nvgCtx,width);
         return *this;
     }
 
     Canvas& Canvas::miterLimit(float limit)
     {
-        nvgMiterLimit(m_nvgCtx,limit);
+        if( changeState(RenderState::MiterLimit,m_state.miterLimit,limit) )
+            nvgMiterLimit(m_nvgCtx,limit);
         return *this;
     }
 
 
     Canvas& Canvas::fillStyle(const Color& color)
     {
-        nvgFillColor(m_nvgCtx,nvgRGBA(color.r,color.g,color.b,color.a));
+        if( changeState(RenderState::FillColor,m_state.fillColor,color.code()) )
+            nvgFillColor(m_nvgCtx,nvgRGBA(color.r,color.g,color.b,color.a));
         return *this;
     }
 
@@ -133,7 +171,11 @@ namespace NanoCanvas
         if (paint.type != Paint::Type::None )
         {
             NVGpaint npaint = nvgPaint(*this,paint);
+            if( m_layer )
+                layerPaint(paint,npaint);
             nvgFillPaint(m_nvgCtx,npaint);
+            m_state.known &= ~RenderState::FillColor;
+            NANOCANVAS_STAT(stateChanges,1);
         }
         return *this;
     }
@@ -143,17 +185,93 @@ namespace NanoCanvas
         if (paint.type != Paint::Type::None )
         {
             NVGpaint npaint = nvgPaint(*this,paint);
+            if( m_layer )
+                layerPaint(paint,npaint);
             nvgStrokePaint(m_nvgCtx,npaint);
+            m_state.known &= ~RenderState::StrokeColor;
+            NANOCANVAS_STAT(stateChanges,1);
         }
         return *this;
     }
 
     Canvas& Canvas::strokeStyle(const Color& color)
     {
-        nvgStrokeColor(m_nvgCtx,nvgRGBA(color.r,color.g,color.b,color.a));
+        if( changeState(RenderState::StrokeColor,m_state.strokeColor,color.code()) )
+            nvgStrokeColor(m_nvgCtx,nvgRGBA(color.r,color.g,color.b,color.a));
+        return *this;
+    }
+
+    Canvas& Canvas::fillStyle(const CompiledPaint& paint)
+    {
+        if( paint.valid() )
+            applyPaint(paint,false);
         return *this;
     }
 
+    Canvas& Canvas::strokeStyle(const CompiledPaint& paint)
+    {
+        if( paint.valid() )
+            applyPaint(paint,true);
+        return *this;
+    }
+
+    CompiledPaint Canvas::compilePaint(const Paint& paint)
+    {
+        CompiledPaint compiled;
+        compiled.m_source = paint;
+        if( compiled.valid() )
+            resolvePaint(compiled);
+        return compiled;
+    }
+
+    unsigned long Canvas::nextEpoch()
+    {
+        // Starts above the epoch of paints never compiled
+        static std::atomic<unsigned long> epoch(0UL);
+        return ++epoch;
+    }
+
+    void Canvas::resolvePaint(const CompiledPaint& paint)
+    {
+        NVGpaint npaint = nvgPaint(*this,paint.m_source);
+        if( m_layer )
+            layerPaint(paint.m_source,npaint);
+        std::copy(npaint.xform,npaint.xform + 6,paint.m_xform);
+        std::copy(npaint.extent,npaint.extent + 2,paint.m_extent);
+        paint.m_radius = npaint.radius;
+        paint.m_feather = npaint.feather;
+        std::copy(npaint.innerColor.rgba,npaint.innerColor.rgba + 4,paint.m_innerColor);
+        std::copy(npaint.outerColor.rgba,npaint.outerColor.rgba + 4,paint.m_outerColor);
+        paint.m_image = npaint.image;
+        paint.m_canvas = this;
+        paint.m_epoch = m_positionEpoch;
+    }
+
+    void Canvas::applyPaint(const CompiledPaint& paint,bool stroke)
+    {
+        if( paint.m_canvas != this || paint.m_epoch != m_positionEpoch )
+            resolvePaint(paint);
+        NVGpaint npaint;
+        std::copy(paint.m_xform,paint.m_xform + 6,npaint.xform);
+        std::copy(paint.m_extent,paint.m_extent + 2,npaint.extent);
+        npaint.radius = paint.m_radius;
+        npaint.feather = paint.m_feather;
+        std::copy(paint.m_innerColor,paint.m_innerColor + 4,npaint.innerColor.rgba);
+        std::copy(paint.m_outerColor,paint.m_outerColor + 4,npaint.outerColor.rgba);
+        npaint.image = paint.m_image;
+        if( stroke )
+        {
+            nvgStrokePaint(m_nvgCtx,npaint);
+            m_state.known &= ~RenderState::StrokeColor;
+        }
+        else
+        {
+            nvgFillPaint(m_nvgCtx,npaint);
+            m_state.known &= ~RenderState::FillColor;
+        }
+        NANOCANVAS_STAT(stateChanges,1);
+    }
+
     Paint Canvas::createLinearGradient(float x0,float y0,float x1,float y1,
                                       const Color& scolor , const Color& ecolor)
     {
@@ -168,6 +286,17 @@ namespace NanoCanvas
         return gdt;
     }
     
+    Paint Canvas::createLinearGradient(float x0,float y0,float x1,float y1)
+    {
+        Paint gdt;
+        gdt.type = Paint::Type::Linear;
+        gdt.xx = x0;
+        gdt.yy = y0;
+        gdt.aa = x1;
+        gdt.bb = y1;
+        return gdt;
+    }
+    
     Paint Canvas::createRadialGradient(float cx,float cy,float r1,float r2,
                                   const Color& icolor , const Color& ocolor)
     {
@@ -182,6 +311,130 @@ namespace NanoCanvas
         return gdt;
     }
 
+    Paint Canvas::createRadialGradient(float cx,float cy,float r1,float r2)
+    {
+        Paint gdt;
+        gdt.type = Paint::Type::Radial;
+        gdt.xx = cx;
+        gdt.yy = cy;
+        gdt.aa = r1;
+        gdt.bb = r2;
+        return gdt;
+    }
+
+    /// The size of textures baked for gradients
+    static const int GradientTextureSize = 256;
+
+    /// The bytes of baked gradient textures kept in a context, 64 radial discs
+    static const size_t GradientCacheBytes = 16UL << 20;
+
+    /// Write the color of a gradient at a position as premultiplied RGBA, interpolated like NanoVG does
+    static void sampleStops(const std::vector<ColorStop>& stops,float t,unsigned char* rgba)
+    {
+        size_t next = 0;
+        while( next < stops.size() && stops[next].offset <= t )
+            ++next;
+        const Color& a = stops[next ? next - 1 : 0].color;
+        const Color& b = stops[next < stops.size() ? next : stops.size() - 1].color;
+        float k = 0.0f;
+        if( next && next < stops.size() )
+        {
+            float span = stops[next].offset - stops[next-1].offset;
+            k = span > 0.0f ? ( t - stops[next-1].offset ) / span : 1.0f;
+        }
+        float aa = a.a / 255.0f;
+        float ba = b.a / 255.0f;
+        rgba[0] = (unsigned char)( a.r*aa + ( b.r*ba - a.r*aa )*k + 0.5f );
+        rgba[1] = (unsigned char)( a.g*aa + ( b.g*ba - a.g*aa )*k + 0.5f );
+        rgba[2] = (unsigned char)( a.b*aa + ( b.b*ba - a.b*aa )*k + 0.5f );
+        rgba[3] = (unsigned char)( a.a + ( b.a - a.a )*k + 0.5f );
+    }
+    
+    void Canvas::deleteRetiredGradients()
+    {
+        for( int image : m_gradientImages.retired )
+            nvgDeleteImage(m_nvgCtx,image);
+        m_gradientImages.retired.clear();
+    }
+
+    int Canvas::gradientImage(const Paint& gradient)
+    {
+        bool radial = gradient.type == Paint::Type::Radial;
+        if( gradient.stops.empty() || !m_nvgCtx ||
+            ( !radial && gradient.type != Paint::Type::Linear ) )
+            return 0;
+
+        // The disc only depends on the ratio of radiuses, quantized to limit the count of textures
+        float r = std::max(std::max(gradient.aa,gradient.bb),1e-4f);
+        int inner = radial ? (int)( clamp(gradient.aa / r,0.0f,1.0f)*GradientTextureSize + 0.5f ) : 0;
+        int outer = radial ? (int)( clamp(gradient.bb / r,0.0f,1.0f)*GradientTextureSize + 0.5f ) : 0;
+        string& key = m_gradientKey;
+        key.assign(radial ? "r" : "l");
+        key.append((const char*)&inner,sizeof(inner));
+        key.append((const char*)&outer,sizeof(outer));
+        for( const auto& stop : gradient.stops )
+        {
+            unsigned code = stop.color.code();
+            key.append((const char*)&stop.offset,sizeof(stop.offset));
+            key.append((const char*)&code,sizeof(code));
+        }
+        GradientCache& cache = m_gradientImages;
+        auto found = cache.index.find(key);
+        if( found != cache.index.end() )
+        {
+            cache.entries.splice(cache.entries.begin(),cache.entries,found->second);
+            return found->second->image;
+        }
+
+        const int size = GradientTextureSize;
+        unsigned char* texels = m_arena.allocate<unsigned char>(radial ? size*size*4 : size*4);
+        int image = 0;
+        if( radial )
+        {
+            float a = (float)inner / size;
+            float b = (float)outer / size;
+            for( int y = 0 ; y < size ; ++y )
+            {
+                for( int x = 0 ; x < size ; ++x )
+                {
+                    float px = ( x + 0.5f )*2.0f / size - 1.0f;
+                    float py = ( y + 0.5f )*2.0f / size - 1.0f;
+                    float d = std::sqrt(px*px + py*py);
+                    float t = a != b ? ( d - a ) / ( b - a ) : ( d < a ? 0.0f : 1.0f );
+                    sampleStops(gradient.stops,clamp(t,0.0f,1.0f),&texels[(y*size + x)*4]);
+                }
+            }
+            image = nvgCreateImageRGBA(m_nvgCtx,size,size,NVG_IMAGE_PREMULTIPLIED,texels);
+        }
+        else
+        {
+            for( int x = 0 ; x < size ; ++x )
+                sampleStops(gradient.stops,( x + 0.5f ) / size,&texels[x*4]);
+            image = nvgCreateImageRGBA(m_nvgCtx,size,1,NVG_IMAGE_PREMULTIPLIED,texels);
+        }
+        if( !image )
+            return 0;
+        
+        GradientCache::Entry entry;
+        entry.key = key;
+        entry.image = image;
+        entry.bytes = radial ? size*size*4 : size*4;
+        cache.entries.push_front(entry);
+        cache.index[key] = cache.entries.begin();
+        cache.bytes += entry.bytes;
+        // Evicted textures may still be drawn in this frame, compiled paints resolve them again
+        while( cache.bytes > GradientCacheBytes && cache.entries.size() > 1 )
+        {
+            const GradientCache::Entry& last = cache.entries.back();
+            cache.retired.push_back(last.image);
+            cache.bytes -= last.bytes;
+            cache.index.erase(last.key);
+            cache.entries.pop_back();
+            m_positionEpoch = nextEpoch();
+        }
+        return image;
+    }
+    
     Paint Canvas::createBoxGradient(float x, float y, float w, float h,
                                float r, float f, Color icol, Color ocol)
     {
@@ -212,78 +465,356 @@ namespace NanoCanvas
         gdt.dd = alpha;
         return gdt;
     }
+    
+    Paint Canvas::createPattern(const SubImage& image,float ox, float oy, 
+                                float w, float h,float angle, float alpha)
+    {
+        Paint gdt;
+        int imageID = 0;
+        float region[4];
+        if( !image.valid() || !image.atlas->locate(image,imageID,region) )
+            return gdt;
+        int pw = 0, ph = 0;
+        image.atlas->pageSize(pw,ph);
+        // Move the origin of the page so that the packed image lands on (ox,oy)
+        float kx = w / region[2];
+        float ky = h / region[3];
+        float dx = -region[0]*kx;
+        float dy = -region[1]*ky;
+        float cs = std::cos(angle);
+        float sn = std::sin(angle);
+        gdt.type = Paint::Type::ImagePattern;
+        gdt.imageID = imageID;
+        gdt.xx = ox + dx*cs - dy*sn;
+        gdt.yy = oy + dx*sn + dy*cs;
+        gdt.aa = pw*kx;
+        gdt.bb = ph*ky;
+        gdt.cc = angle;
+        gdt.dd = alpha;
+        return gdt;
+    }
 
     Canvas& Canvas::font(const Font& font)
     {
         if(font.valid())
-            nvgFontFaceId(m_nvgCtx,font.face);
+            fontFace(font.face);
         return *this;
     }
     
     Canvas& Canvas::font(float size)
     {
-        nvgFontSize(m_nvgCtx,size);
+        if( changeState(RenderState::FontSize,m_state.fontSize,size) )
+            nvgFontSize(m_nvgCtx,size);
         return *this;
     }
     
     Canvas& Canvas::textAlign( HorizontalAlign hAlign,VerticalAlign vAlign)
     {
-        nvgTextAlign(m_nvgCtx,hAlign|vAlign);
+        int align = hAlign|vAlign;
+        if( changeState(RenderState::TextAlign,m_state.textAlign,align) )
+            nvgTextAlign(m_nvgCtx,align);
         return *this;
     }
     
-    void applyTextStyle(Canvas& canvas,const TextStyle& textStyle )
+    void Canvas::fontFace(int face)
+    {
+        if( changeState(RenderState::FontFace,m_state.fontFace,face) )
+            nvgFontFaceId(m_nvgCtx,face);
+    }
+    
+    void Canvas::applyTextStyle(const TextStyle& textStyle )
     {
         if( textStyle.face>=0 )
-            nvgFontFaceId(canvas.nvgContext(),textStyle.face);
-        if( !std::isnan(textStyle.lineHeight) )
-            nvgTextLineHeight(canvas.nvgContext(),textStyle.lineHeight);
-        if( !std::isnan(textStyle.blur) )
-            nvgFontBlur(canvas.nvgContext(),textStyle.blur);
-        if( !std::isnan(textStyle.letterSpace))
-            nvgTextLetterSpacing(canvas.nvgContext(),textStyle.letterSpace);
-        nvgTextAlign(canvas.nvgContext(),textStyle.hAlign|textStyle.vAlign);
-        nvgFontSize(canvas.nvgContext(),textStyle.size);
+            fontFace(textStyle.face);
+        if( !std::isnan(textStyle.lineHeight) &&
+            changeState(RenderState::LineHeight,m_state.lineHeight,textStyle.lineHeight) )
+            nvgTextLineHeight(m_nvgCtx,textStyle.lineHeight);
+        if( !std::isnan(textStyle.blur) &&
+            changeState(RenderState::FontBlur,m_state.fontBlur,textStyle.blur) )
+            nvgFontBlur(m_nvgCtx,textStyle.blur);
+        if( !std::isnan(textStyle.letterSpace) &&
+            changeState(RenderState::LetterSpace,m_state.letterSpace,textStyle.letterSpace) )
+            nvgTextLetterSpacing(m_nvgCtx,textStyle.letterSpace);
+        textAlign(textStyle.hAlign,textStyle.vAlign);
+        font(textStyle.size);
     }
     
     Canvas& Canvas::fillStyle(const TextStyle& textStyle)
     {
-        applyTextStyle(*this,textStyle);
-        nvgFillColor(m_nvgCtx,nvgColor(textStyle.color));
+        applyTextStyle(textStyle);
+        fillStyle(textStyle.color);
         return *this;
     }
     
     float Canvas::measureText(const string& text,float rowWidth)
+    {
+        return measureText(text.data(),text.data() + text.size(),rowWidth);
+    }
+    
+    float Canvas::measureText(const char* text,float rowWidth)
+    {
+        return measureText(text,nullptr,rowWidth);
+    }
+    
+    float Canvas::measureText(const char* text,const char* end,float rowWidth)
     {
         float width = 0;
         if( std::isnan(rowWidth))
-            width =  nvgTextBounds(m_nvgCtx,0,0,text.c_str(),nullptr,nullptr);
+            width =  nvgTextBounds(m_nvgCtx,0,0,text,end,nullptr);
         else
         {
             float bouds[4]{0};
-            width = measureText(text,0,0,bouds,rowWidth);
+            width = measureText(text,end,0,0,bouds,rowWidth);
         }
         return width;
     }
     
     float Canvas::measureText(const string& text,float x,float y,
                               float* bounds,float rowWidth)
+    {
+        return measureText(text.data(),text.data() + text.size(),x,y,bounds,rowWidth);
+    }
+    
+    float Canvas::measureText(const char* text,float x,float y,
+                              float* bounds,float rowWidth)
+    {
+        return measureText(text,nullptr,x,y,bounds,rowWidth);
+    }
+    
+    float Canvas::measureText(const char* text,const char* end,float x,float y,
+                              float* bounds,float rowWidth)
     {
         local2Global(x,y);
         if( std::isnan(rowWidth))
-            nvgTextBounds(m_nvgCtx,x,y,text.c_str(),nullptr,bounds);
+            nvgTextBounds(m_nvgCtx,x,y,text,end,bounds);
         else
-            nvgTextBoxBounds(m_nvgCtx,x,y,rowWidth,text.c_str(),nullptr,bounds);
+            nvgTextBoxBounds(m_nvgCtx,x,y,rowWidth,text,end,bounds);
         float width = 0;
         if( bounds )
             width = bounds[2] - bounds[0];
         return width;
     }
     
+    float Canvas::measureText(const TextLayout& layout)
+    {
+        layoutText(layout);
+        return layout.m_width;
+    }
+    
+    float Canvas::measureText(const TextLayout& layout,float x,float y,float* bounds)
+    {
+        layoutText(layout);
+        local2Global(x,y);
+        if( bounds )
+        {
+            bounds[0] = layout.m_bounds[0] + x;
+            bounds[1] = layout.m_bounds[1] + y;
+            bounds[2] = layout.m_bounds[2] + x;
+            bounds[3] = layout.m_bounds[3] + y;
+        }
+        return layout.m_width;
+    }
+    
+    void Canvas::layoutText(const TextLayout& layout)
+    {
+        TextMetricsKey key;
+        textMetricsKey(layout.m_style,key);
+        if( key.generation && layout.m_key == key )
+            return;
+        const char* begin = layout.m_text.data();
+        const char* end = begin + layout.m_text.size();
+        save();
+        applyTextStyle(layout.m_style);
+        layout.m_width = nvgTextBounds(m_nvgCtx,0,0,begin,end,layout.m_bounds);
+        // A glyph takes one byte at least
+        std::vector<NVGglyphPosition> positions(layout.m_text.size());
+        int count = nvgTextGlyphPositions(m_nvgCtx,0,0,begin,end,
+                                          positions.data(),(int)positions.size());
+        layout.m_glyphs.resize(count);
+        for( int i = 0 ; i < count ; ++i )
+        {
+            TextLayout::Glyph& glyph = layout.m_glyphs[i];
+            glyph.index = positions[i].str - begin;
+            glyph.x = positions[i].x;
+            glyph.minx = positions[i].minx;
+            glyph.maxx = positions[i].maxx;
+        }
+        restore();
+        layout.m_key = key;
+    }
+    
+    float Canvas::measureText(const TextBox& box,float x,float y,float* bounds)
+    {
+        layoutText(box);
+        local2Global(x,y);
+        if( bounds )
+        {
+            bounds[0] = box.m_bounds[0] + x;
+            bounds[1] = box.m_bounds[1] + y;
+            bounds[2] = box.m_bounds[2] + x;
+            bounds[3] = box.m_bounds[3] + y;
+        }
+        return box.m_bounds[2] - box.m_bounds[0];
+    }
+    
+    /// The x-offset of a row in a text box for the horizontal alignment
+    static float rowOffset(const TextBox& box,const TextBox::Row& row)
+    {
+        if( box.style().hAlign & TextAlign::Center )
+            return ( box.rowWidth() - row.width )*0.5f;
+        if( box.style().hAlign & TextAlign::Right )
+            return box.rowWidth() - row.width;
+        return 0.0f;
+    }
+    
+    void Canvas::layoutText(const TextBox& box)
+    {
+        TextMetricsKey key;
+        textMetricsKey(box.m_style,key);
+        if( key.generation && box.m_key == key )
+            return;
+        const char* begin = box.m_text.data();
+        const char* end = begin + box.m_text.size();
+        save();
+        applyTextStyle(box.m_style);
+        // Rows are placed by their offsets like nvgTextBox does
+        textAlign(TextAlign::Left,box.m_style.vAlign);
+        float lineh = 0;
+        nvgTextMetrics(m_nvgCtx,nullptr,nullptr,&lineh);
+        box.m_lineAdvance = lineh*( std::isnan(box.m_style.lineHeight) ? 1.0f : box.m_style.lineHeight );
+        
+        box.m_rows.clear();
+        NVGtextRow rows[16];
+        const char* next = begin;
+        int count = 0;
+        while( ( count = nvgTextBreakLines(m_nvgCtx,next,end,box.m_rowWidth,rows,16) ) )
+        {
+            for( int i = 0 ; i < count ; ++i )
+            {
+                TextBox::Row row;
+                row.start = rows[i].start - begin;
+                row.end = rows[i].end - begin;
+                row.width = rows[i].width;
+                row.minx = rows[i].minx;
+                row.maxx = rows[i].maxx;
+                box.m_rows.push_back(row);
+            }
+            next = rows[count-1].next;
+        }
+        
+        float* bounds = box.m_bounds;
+        bounds[0] = bounds[1] = bounds[2] = bounds[3] = 0.0f;
+        if( box.m_rows.size() )
+        {
+            // The vertical bounds of rows don't depend on their text
+            const TextBox::Row& first = box.m_rows.front();
+            float line[4];
+            nvgTextBounds(m_nvgCtx,0,0,begin + first.start,begin + first.end,line);
+            bounds[0] = INFINITY;
+            bounds[2] = -INFINITY;
+            for( const auto& row : box.m_rows )
+            {
+                float dx = rowOffset(box,row);
+                bounds[0] = std::min(bounds[0],dx + row.minx);
+                bounds[2] = std::max(bounds[2],dx + row.maxx);
+            }
+            bounds[1] = line[1];
+            bounds[3] = line[3] + box.m_lineAdvance*(box.m_rows.size() - 1);
+        }
+        restore();
+        box.m_key = key;
+    }
+    
+    void Canvas::windowBounds(float& minx,float& miny,float& maxx,float& maxy)
+    {
+        const float* xform = getTransform();
+        local2Global(minx,miny);
+        local2Global(maxx,maxy);
+        const float corners[8] = { minx,miny, maxx,miny, maxx,maxy, minx,maxy };
+        minx = miny = INFINITY;
+        maxx = maxy = -INFINITY;
+        for( int i = 0 ; i < 8 ; i += 2 )
+        {
+            float x,y;
+            nvgTransformPoint(&x,&y,xform,corners[i],corners[i+1]);
+            minx = std::min(minx,x);
+            miny = std::min(miny,y);
+            maxx = std::max(maxx,x);
+            maxy = std::max(maxy,y);
+        }
+    }
+    
+    bool Canvas::rejected(float minx,float miny,float maxx,float maxy)
+    {
+        windowBounds(minx,miny,maxx,maxy);
+        // Antialiasing fringes reach a pixel out of the shapes
+        const float fringe = 1.0f;
+        float x0 = m_xPos - fringe, y0 = m_yPos - fringe;
+        float x1 = m_xPos + m_width + fringe, y1 = m_yPos + m_height + fringe;
+        if( m_repainting )
+        {
+            x0 = std::max(x0,m_repaintRect.x0 - fringe);
+            y0 = std::max(y0,m_repaintRect.y0 - fringe);
+            x1 = std::min(x1,m_repaintRect.x1 + fringe);
+            y1 = std::min(y1,m_repaintRect.y1 + fringe);
+        }
+        const float* clip = m_state.clip;
+        x0 = std::max(x0,clip[0] - fringe);
+        y0 = std::max(y0,clip[1] - fringe);
+        x1 = std::min(x1,clip[2] + fringe);
+        y1 = std::min(y1,clip[3] + fringe);
+        return maxx < x0 || maxy < y0 || minx > x1 || miny > y1;
+    }
+    
+    bool Canvas::pathRejected(float reach)
+    {
+        if( !m_path.known || m_path.empty() || std::isnan(reach) )
+            return false;
+        return rejected(m_path.x0 - reach,m_path.y0 - reach,m_path.x1 + reach,m_path.y1 + reach);
+    }
+    
+    float Canvas::strokeReach()const
+    {
+        const unsigned style = RenderState::LineWidth | RenderState::MiterLimit;
+        if( ( m_state.known & style ) != style )
+            return NAN;
+        // Miter joins reach the farthest, square caps reach less than the default miter limit
+        return m_state.lineWidth*0.5f*std::max(m_state.miterLimit,1.5f);
+    }
+    
+    bool Canvas::textRejected(const char* text,const char* end,float x,float y,float rowWidth)
+    {
+        const unsigned style = RenderState::FontSize | RenderState::LetterSpace | RenderState::FontBlur |
+                               RenderState::TextAlign | RenderState::LineHeight;
+        if( ( m_state.known & style ) != style )
+            return false;
+        // No glyph is wider than two ems, even a character of one byte
+        size_t bytes = end ? (size_t)( end - text ) : std::strlen(text);
+        float em = m_state.fontSize*2.0f + m_state.fontBlur;
+        float width = bytes*( em + std::max(m_state.letterSpace,0.0f) );
+        float x0 = x - width, x1 = x + width;
+        float y0 = y - em, y1 = y + em;
+        if( !std::isnan(rowWidth) )
+        {
+            // The rows are aligned in the box and go downward
+            x0 = x - em;
+            x1 = x + rowWidth + em;
+            y1 += bytes*m_state.fontSize*std::max(m_state.lineHeight,1.0f);
+        }
+        else if( m_state.textAlign & NVG_ALIGN_LEFT )
+            x0 = x;
+        else if( m_state.textAlign & NVG_ALIGN_RIGHT )
+            x1 = x;
+        return rejected(x0,y0,x1,y1);
+    }
+    
 /* ------------------- Basic Path ----------------------*/
 
     Canvas& Canvas::moveTo(float x,float y)
     {
+        m_path.add(x,y,x,y);
+        if( Path2D* path = recordedPath() )
+            path->moveTo(x,y);
         local2Global(x,y);
         nvgMoveTo(m_nvgCtx,x,y);
         return *this;
@@ -291,6 +822,9 @@ namespace NanoCanvas
 
     Canvas& Canvas::lineTo(float x,float y)
     {
+        m_path.add(x,y,x,y);
+        if( Path2D* path = recordedPath() )
+            path->lineTo(x,y);
         local2Global(x,y);
         nvgLineTo(m_nvgCtx,x,y);
         return *this;
@@ -298,6 +832,10 @@ namespace NanoCanvas
 
     Canvas& Canvas::arcTo(float x1,float y1,float x2,float y2,float r)
     {
+        // The arc can end far beyond the control points
+        m_path.known = false;
+        if( Path2D* path = recordedPath() )
+            path->arcTo(x1,y1,x2,y2,r);
         local2Global(x1,y1);
         local2Global(x2,y2);
         nvgArcTo(m_nvgCtx,x1,y1,x2,y2,r);
@@ -306,6 +844,11 @@ namespace NanoCanvas
 
     Canvas& Canvas::quadraticCurveTo(float cpx,float cpy,float x, float y)
     {
+        // Curves are inside the hull of their control points
+        m_path.add(cpx,cpy,cpx,cpy);
+        m_path.add(x,y,x,y);
+        if( Path2D* path = recordedPath() )
+            path->quadraticCurveTo(cpx,cpy,x,y);
         local2Global(cpx,cpy);
         local2Global(x,y);
         nvgQuadTo(m_nvgCtx,cpx,cpy,x,y);
@@ -316,6 +859,11 @@ namespace NanoCanvas
                                   float cp2x,float cp2y,
                                   float x, float y)
     {
+        m_path.add(cp1x,cp1y,cp1x,cp1y);
+        m_path.add(cp2x,cp2y,cp2x,cp2y);
+        m_path.add(x,y,x,y);
+        if( Path2D* path = recordedPath() )
+            path->bezierCurveTo(cp1x,cp1y,cp2x,cp2y,x,y);
         local2Global(cp1x,cp1y);
         local2Global(cp2x,cp2y);
         local2Global(x,y);
@@ -326,6 +874,9 @@ namespace NanoCanvas
     Canvas& Canvas::arc(float x,float y,float r,
                 float sAngle,float eAngle,bool counterclockwise)
     {
+        m_path.add(x - r,y - r,x + r,y + r);
+        if( Path2D* path = recordedPath() )
+            path->arc(x,y,r,sAngle,eAngle,counterclockwise);
         local2Global(x,y);
         int dir = counterclockwise? NVG_CCW : NVG_CW;
         nvgArc(m_nvgCtx,x,y,r,sAngle,eAngle,dir);
@@ -335,6 +886,8 @@ namespace NanoCanvas
 
     Canvas& Canvas::closePath()
     {
+        if( m_recordedPath )
+            m_recordedPath->closePath();
         nvgClosePath(m_nvgCtx);
         return *this;
     }
@@ -345,6 +898,7 @@ namespace NanoCanvas
 
     Canvas& Canvas::rect(float x,float y,float w,float h)
     {
+        addRectPath(x,y,w,h);
         local2Global(x,y);
         nvgRect(m_nvgCtx,x,y,w,h);
         return *this;
@@ -352,6 +906,9 @@ namespace NanoCanvas
 
     Canvas& Canvas::roundedRect(float x,float y,float w,float h,float r)
     {
+        m_path.add(std::min(x,x + w),std::min(y,y + h),std::max(x,x + w),std::max(y,y + h));
+        if( Path2D* path = recordedPath() )
+            path->roundedRect(x,y,w,h,r);
         local2Global(x,y);
         nvgRoundedRect(m_nvgCtx,x,y,w,h,r);
         return *this;
@@ -359,6 +916,9 @@ namespace NanoCanvas
 
     Canvas& Canvas::circle(float cx ,float cy , float r)
     {
+        m_path.add(cx - r,cy - r,cx + r,cy + r);
+        if( Path2D* path = recordedPath() )
+            path->circle(cx,cy,r);
         local2Global(cx,cy);
         nvgCircle(m_nvgCtx,cx,cy,r);
         return *this;
@@ -366,6 +926,9 @@ namespace NanoCanvas
 
     Canvas& Canvas::ellipse(float cx, float cy, float rx, float ry)
     {
+        m_path.add(cx - rx,cy - ry,cx + rx,cy + ry);
+        if( Path2D* path = recordedPath() )
+            path->ellipse(cx,cy,rx,ry);
         local2Global(cx,cy);
         nvgEllipse(m_nvgCtx,cx,cy,rx,ry);
         return *this;
@@ -375,18 +938,36 @@ namespace NanoCanvas
 
     Canvas& Canvas::fill()
     {
+        NANOCANVAS_TIMER;
+        if( pathRejected(0.0f) )
+            return *this;
+        addPathHit(0.0f);
+        NANOCANVAS_STAT(fills,1);
         nvgFill(m_nvgCtx);
         return *this;
     }
 
     Canvas& Canvas::stroke()
     {
+        NANOCANVAS_TIMER;
+        if( pathRejected(strokeReach()) )
+            return *this;
+        addPathHit(strokeReach());
+        NANOCANVAS_STAT(strokes,1);
         nvgStroke(m_nvgCtx);
         return *this;
     }
 
     Canvas& Canvas::fillRect(float x,float y,float w,float h)
     {
+        NANOCANVAS_TIMER;
+        resetPath();
+        addRectPath(x,y,w,h);
+        if( pathRejected(0.0f) )
+            return *this;
+        addPathHit(0.0f);
+        NANOCANVAS_STAT(paths,1);
+        NANOCANVAS_STAT(fills,1);
         local2Global(x,y);
         nvgBeginPath(m_nvgCtx);
         nvgRect(m_nvgCtx,x,y,w,h);
@@ -396,6 +977,14 @@ namespace NanoCanvas
 
     Canvas& Canvas::strokeRect(float x,float y,float w,float h)
     {
+        NANOCANVAS_TIMER;
+        resetPath();
+        addRectPath(x,y,w,h);
+        if( pathRejected(strokeReach()) )
+            return *this;
+        addPathHit(strokeReach());
+        NANOCANVAS_STAT(paths,1);
+        NANOCANVAS_STAT(strokes,1);
         local2Global(x,y);
         nvgBeginPath(m_nvgCtx);
         nvgRect(m_nvgCtx,x,y,w,h);
@@ -403,11 +992,89 @@ namespace NanoCanvas
         return *this;
     }
 
+    Canvas& Canvas::fillRects(const float* xywh,size_t count)
+    {
+        NANOCANVAS_TIMER;
+        resetPath();
+        for( size_t i = 0 ; i < count ; ++i )
+            addRectPath(xywh[i*4],xywh[i*4+1],xywh[i*4+2],xywh[i*4+3]);
+        // The whole batch is drawn or skipped at once
+        if( count && !pathRejected(0.0f) )
+        {
+            NANOCANVAS_STAT(paths,1);
+            NANOCANVAS_STAT(fills,1);
+            nvgBeginPath(m_nvgCtx);
+            for( size_t i = 0 ; i < count ; ++i , xywh += 4 )
+            {
+                float x = xywh[0];
+                float y = xywh[1];
+                addHit(std::min(x,x + xywh[2]),std::min(y,y + xywh[3]),
+                       std::max(x,x + xywh[2]),std::max(y,y + xywh[3]));
+                local2Global(x,y);
+                nvgRect(m_nvgCtx,x,y,xywh[2],xywh[3]);
+            }
+            nvgFill(m_nvgCtx);
+        }
+        return *this;
+    }
+
+    Canvas& Canvas::fillRects(const float* xywh,const Color* colors,size_t count)
+    {
+        size_t first = 0;
+        while( first < count )
+        {
+            // Submit the run of rectangles sharing the same color
+            size_t last = first + 1;
+            while( last < count && colors[last].code() == colors[first].code() )
+                ++last;
+            fillStyle(colors[first]);
+            fillRects(xywh + first*4,last - first);
+            first = last;
+        }
+        return *this;
+    }
+
+    Canvas& Canvas::strokeRects(const float* xywh,size_t count)
+    {
+        NANOCANVAS_TIMER;
+        resetPath();
+        for( size_t i = 0 ; i < count ; ++i )
+            addRectPath(xywh[i*4],xywh[i*4+1],xywh[i*4+2],xywh[i*4+3]);
+        // The whole batch is drawn or skipped at once
+        float reach = strokeReach();
+        if( count && !pathRejected(reach) )
+        {
+            NANOCANVAS_STAT(paths,1);
+            NANOCANVAS_STAT(strokes,1);
+            nvgBeginPath(m_nvgCtx);
+            if( std::isnan(reach) )
+                reach = 0.0f;
+            for( size_t i = 0 ; i < count ; ++i , xywh += 4 )
+            {
+                float x = xywh[0];
+                float y = xywh[1];
+                addHit(std::min(x,x + xywh[2]) - reach,std::min(y,y + xywh[3]) - reach,
+                       std::max(x,x + xywh[2]) + reach,std::max(y,y + xywh[3]) + reach);
+                local2Global(x,y);
+                nvgRect(m_nvgCtx,x,y,xywh[2],xywh[3]);
+            }
+            nvgStroke(m_nvgCtx);
+        }
+        return *this;
+    }
+
     Canvas& Canvas::clearColor(const Color& color)
     {
-        nvgCancelFrame(m_nvgCtx);
-        nvgFillColor(m_nvgCtx,nvgRGBA(color.r,color.g,color.b,color.a));
+        NANOCANVAS_TIMER;
+        NANOCANVAS_STAT(paths,1);
+        NANOCANVAS_STAT(fills,1);
+        // The areas repainted before must be kept
+        if( !m_repainting )
+            nvgCancelFrame(m_nvgCtx);
+        fillStyle(color);
         nvgBeginPath(m_nvgCtx);
+        resetPath();
+        m_path.known = false;
         nvgRect(m_nvgCtx,m_xPos,m_yPos,m_width,m_height);
         nvgFill(m_nvgCtx);
         
@@ -416,94 +1083,438 @@ namespace NanoCanvas
 
     Canvas& Canvas::fillText(const string& text,float x,float y,float rowWidth)
     {
-        if(text.length())
+        return fillText(text.data(),text.data() + text.size(),x,y,rowWidth);
+    }
+    
+    Canvas& Canvas::fillText(const char* text,float x,float y,float rowWidth)
+    {
+        return fillText(text,nullptr,x,y,rowWidth);
+    }
+    
+    Canvas& Canvas::fillText(const char* text,const char* end,float x,float y,float rowWidth)
+    {
+        NANOCANVAS_TIMER;
+        if( text && ( end ? end > text : *text != 0 ) && !textRejected(text,end,x,y,rowWidth) )
         {
+            NANOCANVAS_STAT(texts,1);
+            // Text is only measured for hit testing
+            if( m_hitID && m_nvgCtx )
+            {
+                float bounds[4];
+                if( std::isnan(rowWidth) )
+                    nvgTextBounds(m_nvgCtx,x,y,text,end,bounds);
+                else
+                    nvgTextBoxBounds(m_nvgCtx,x,y,rowWidth,text,end,bounds);
+                addHit(bounds[0],bounds[1],bounds[2],bounds[3]);
+            }
             local2Global(x,y);
             if( std::isnan(rowWidth) )
-                nvgText(m_nvgCtx,x,y,text.c_str(),nullptr);
+                nvgText(m_nvgCtx,x,y,text,end);
             else
-                nvgTextBox(m_nvgCtx,x,y,rowWidth,text.c_str(),nullptr);
+                nvgTextBox(m_nvgCtx,x,y,rowWidth,text,end);
+        }
+        return *this;
+    }
+    
+    Canvas& Canvas::fillText(const TextLayout& layout,float x,float y)
+    {
+        NANOCANVAS_TIMER;
+        if( layout.m_text.empty() )
+            return *this;
+        layoutText(layout);
+        fillStyle(layout.m_style);
+        const float* bounds = layout.m_bounds;
+        if( rejected(x + bounds[0],y + bounds[1],x + bounds[2],y + bounds[3]) )
+            return *this;
+        addHit(x + bounds[0],y + bounds[1],x + bounds[2],y + bounds[3]);
+        NANOCANVAS_STAT(texts,1);
+        local2Global(x,y);
+        const char* begin = layout.m_text.data();
+        nvgText(m_nvgCtx,x,y,begin,begin + layout.m_text.size());
+        return *this;
+    }
+    
+    Canvas& Canvas::fillText(const TextBox& box,float x,float y)
+    {
+        NANOCANVAS_TIMER;
+        if( box.m_text.empty() )
+            return *this;
+        layoutText(box);
+        fillStyle(box.m_style);
+        const float* bounds = box.m_bounds;
+        if( rejected(x + bounds[0],y + bounds[1],x + bounds[2],y + bounds[3]) )
+            return *this;
+        addHit(x + bounds[0],y + bounds[1],x + bounds[2],y + bounds[3]);
+        
+        textAlign(TextAlign::Left,box.m_style.vAlign);
+        const char* text = box.m_text.data();
+        // The vertical bounds of a row relative to its origin
+        float top = bounds[1];
+        float bottom = bounds[3] - box.m_lineAdvance*(box.m_rows.size() - 1);
+        float rowY = y;
+        for( const auto& row : box.m_rows )
+        {
+            float rowX = x + rowOffset(box,row);
+            if( !rejected(rowX + row.minx,rowY + top,rowX + row.maxx,rowY + bottom) )
+            {
+                float gx = rowX;
+                float gy = rowY;
+                local2Global(gx,gy);
+                NANOCANVAS_STAT(texts,1);
+                nvgText(m_nvgCtx,gx,gy,text + row.start,text + row.end);
+            }
+            rowY += box.m_lineAdvance;
         }
+        textAlign(box.m_style.hAlign,box.m_style.vAlign);
         return *this;
     }
     
+    /// How many text styles keep their character advances
+    static const size_t MaxCharAdvances = 8;
+    
+    /// The scale NanoVG rasterizes text at, the average scale of the transform quantized and capped
+    static float fontScale(const float* xform,float pixelRatio)
+    {
+        float sx = std::sqrt(xform[0]*xform[0] + xform[2]*xform[2]);
+        float sy = std::sqrt(xform[1]*xform[1] + xform[3]*xform[3]);
+        float scale = std::floor((sx + sy)*0.5f/0.01f + 0.5f)*0.01f;
+        return std::min(scale,4.0f)*pixelRatio;
+    }
+    
+    void Canvas::textMetricsKey(const TextStyle& style,TextMetricsKey& key)
+    {
+        // The fields the style leaves unset come from the current state
+        key.face = style.face >= 0 ? style.face : m_state.fontFace;
+        key.size = style.size;
+        key.letterSpace = std::isnan(style.letterSpace) ? m_state.letterSpace : style.letterSpace;
+        key.lineHeight = std::isnan(style.lineHeight) ? m_state.lineHeight : style.lineHeight;
+        key.scale = fontScale(getTransform(),m_scaleRatio);
+        key.generation = m_textGeneration;
+        // Metrics computed with an unknown state can't be reused
+        if( ( style.face < 0 && !( m_state.known & RenderState::FontFace ) ) ||
+            ( std::isnan(style.letterSpace) && !( m_state.known & RenderState::LetterSpace ) ) ||
+            ( std::isnan(style.lineHeight) && !( m_state.known & RenderState::LineHeight ) ) )
+            key.generation = 0UL;
+    }
+    
+    Canvas::CharAdvances* Canvas::charAdvances()
+    {
+        const unsigned style = RenderState::FontFace | RenderState::FontSize | RenderState::LetterSpace;
+        if( ( m_state.known & style ) != style || !m_nvgCtx )
+            return nullptr;
+        float scale = fontScale(getTransform(),m_scaleRatio);
+        for( size_t i = 0 ; i < m_charAdvances.size() ; ++i )
+        {
+            CharAdvances& advances = m_charAdvances[i];
+            if( advances.face == m_state.fontFace && advances.size == m_state.fontSize &&
+                advances.letterSpace == m_state.letterSpace && advances.scale == scale )
+            {
+                if( i )
+                    std::swap(m_charAdvances[i],m_charAdvances[0]);
+                return &m_charAdvances[0];
+            }
+        }
+        
+        CharAdvances advances;
+        advances.face = m_state.fontFace;
+        advances.size = m_state.fontSize;
+        advances.letterSpace = m_state.letterSpace;
+        advances.scale = scale;
+        advances.lineHeight = m_state.fontSize;
+        nvgTextMetrics(m_nvgCtx,nullptr,nullptr,&advances.lineHeight);
+        std::fill(advances.advance,advances.advance + 128,NAN);
+        if( m_charAdvances.size() < MaxCharAdvances )
+            m_charAdvances.push_back(advances);
+        else
+            m_charAdvances.back() = advances;
+        std::swap(m_charAdvances.back(),m_charAdvances[0]);
+        return &m_charAdvances[0];
+    }
+    
+    Canvas& Canvas::fillNumber(double value,const NumberFormat& format,float x,float y)
+    {
+        NANOCANVAS_TIMER;
+        char text[64];
+        size_t length = format.format(value,text,sizeof(text));
+        CharAdvances* advances = charAdvances();
+        if( !length || !advances || !( m_state.known & RenderState::TextAlign ) )
+            return fillText(text,text + length,x,y);
+        
+        float width = 0.0f;
+        for( size_t i = 0 ; i < length ; ++i )
+        {
+            unsigned char c = (unsigned char)text[i];
+            if( c >= 128 )
+                return fillText(text,text + length,x,y);
+            float& advance = advances->advance[c];
+            if( std::isnan(advance) )
+                advance = nvgTextBounds(m_nvgCtx,0,0,text + i,text + i + 1,nullptr);
+            width += advance;
+        }
+        // The letter spacing is only added between characters
+        width += ( length - 1 )*m_state.letterSpace;
+        
+        // Align the number here, NanoVG would measure the text again
+        int align = m_state.textAlign;
+        const int hAligns = NVG_ALIGN_LEFT | NVG_ALIGN_CENTER | NVG_ALIGN_RIGHT;
+        if( align & NVG_ALIGN_RIGHT )
+            x -= width;
+        else if( align & NVG_ALIGN_CENTER )
+            x -= width*0.5f;
+        float lineHeight = advances->lineHeight;
+        if( rejected(x,y - lineHeight,x + width,y + lineHeight) )
+            return *this;
+        addHit(x,y - lineHeight,x + width,y + lineHeight);
+        
+        NANOCANVAS_STAT(texts,1);
+        local2Global(x,y);
+        if( ( align & hAligns ) != NVG_ALIGN_LEFT )
+        {
+            NANOCANVAS_STAT(stateChanges,2);
+            nvgTextAlign(m_nvgCtx,( align & ~hAligns ) | NVG_ALIGN_LEFT);
+            nvgText(m_nvgCtx,x,y,text,text + length);
+            nvgTextAlign(m_nvgCtx,align);
+        }
+        else
+            nvgText(m_nvgCtx,x,y,text,text + length);
+        return *this;
+    }
+    
+    void Canvas::drawImageRegion(int imageID,int textureWidth,int textureHeight,const float* region,
+                                 float x,float y,float width,float height,
+                                 float sx,float sy,float swidth,float sheight)
+    {
+        NANOCANVAS_TIMER;
+        if( std::isnan(swidth) )
+            swidth = region[2] - sx;
+        if( std::isnan(sheight) )
+            sheight = region[3] - sy;
+        if( std::isnan(width) )
+            width = swidth;
+        if( std::isnan(height) )
+            height = sheight;
+        if( swidth <= 0 || sheight <= 0 )
+            return;
+        if( rejected(std::min(x,x + width),std::min(y,y + height),
+                     std::max(x,x + width),std::max(y,y + height)) )
+            return;
+        NANOCANVAS_STAT(images,1);
+        NANOCANVAS_STAT(paths,1);
+        NANOCANVAS_STAT(fills,1);
+        
+        // Map the clipped area of the texture onto the destination rectangle
+        float sw =  width / swidth;
+        float sh =  height / sheight;
+        Paint pattern;
+        pattern.type = Paint::Type::ImagePattern;
+        pattern.imageID = imageID;
+        pattern.xx = x - (region[0] + sx)*sw;
+        pattern.yy = y - (region[1] + sy)*sh;
+        pattern.aa = textureWidth * sw;
+        pattern.bb = textureHeight * sh;
+        pattern.cc = 0.0f;
+        pattern.dd = 1.0f;
+        
+        save();
+        fillStyle(pattern);
+        nvgBeginPath(m_nvgCtx);
+        resetPath();
+        addRectPath(x,y,width,height);
+        addPathHit(0.0f);
+        local2Global(x,y);
+        nvgRect(m_nvgCtx,x,y,width,height);
+        nvgFill(m_nvgCtx);
+        restore();
+    }
+    
     Canvas& Canvas::drawImage(Image& image,float x,float y, 
                               float width,float height,
                               float sx,float sy,float swidth,float sheight)
     {
-        if(image.valid())
+        // Layers draw a copy of the image, the pattern is mapped to it
+        if( image.valid() && ( !m_layer || layerImage(image) ) )
         {
-            save();
-            
-            local2Global(x,y);
-            int w,h;
+            int w = 0,h = 0;
             image.size(w,h);
-            
-            if( std::isnan(swidth) )
-                swidth = w - sx;
-            if( std::isnan(sheight) )
-                sheight = h - sy;
-            if( std::isnan(width) )
-                width = swidth;
-            if( std::isnan(height) )
-                height = sheight;
-            
-            resetClip();
-            clip(x,y,width,height);
-            
-            float sw =  width / swidth;
-            float sh =  height / sheight;
-            float rx,ry,rw,rh;
-            rw = w * sw;
-            rh = h * sh;
-            rx = x - sx*sw;
-            ry = y - sy*sh;
-            
-            Paint pattern = createPattern(image,rx,ry,rw,rh,0,1.0f);
-            fillStyle(pattern);
-            rect(rx,ry,rw,rh).fill();
-            restore();
+            float region[4] = { 0.0f, 0.0f, (float)w, (float)h };
+            drawImageRegion(image.imageID,w,h,region,x,y,width,height,sx,sy,swidth,sheight);
+        }
+        return *this;
+    }
+    
+    Canvas& Canvas::drawImage(const SubImage& image,float x,float y, 
+                              float width,float height,
+                              float sx,float sy,float swidth,float sheight)
+    {
+        // Uploading the atlas pages is a part of drawing
+        NANOCANVAS_TIMER;
+        int imageID = 0;
+        float region[4];
+        if( image.valid() && image.atlas->locate(image,imageID,region) &&
+            ( !m_layer || layerImage(*image.atlas,imageID) ) )
+        {
+            int w = 0,h = 0;
+            image.atlas->pageSize(w,h);
+            drawImageRegion(imageID,w,h,region,x,y,width,height,sx,sy,swidth,sheight);
         }
         return *this;
     }
 
+    Canvas& Canvas::drawImages(const Image& atlas,const float* src,const float* dst,
+                               size_t count,const float* alpha)
+    {
+        NANOCANVAS_TIMER;
+        if( !atlas.valid() || !count || ( m_layer && !layerImage(atlas) ) )
+            return *this;
+
+        int w = 0,h = 0;
+        nvgImageSize(imageContext(),atlas.imageID,&w,&h);
+        save();
+        Paint current;
+        for( size_t i = 0 ; i < count ; ++i , src += 4 , dst += 4 )
+        {
+            if( src[2] <= 0 || src[3] <= 0 )
+                continue;
+            // Map the source rectangle of the atlas onto the destination rectangle
+            float kx = dst[2] / src[2];
+            float ky = dst[3] / src[3];
+            Paint pattern = createPattern(atlas,dst[0] - src[0]*kx,dst[1] - src[1]*ky,
+                                          w*kx,h*ky,0.0f,alpha ? alpha[i] : 1.0f);
+            if( current.type == Paint::Type::None ||
+                pattern.xx != current.xx || pattern.yy != current.yy ||
+                pattern.aa != current.aa || pattern.bb != current.bb ||
+                pattern.dd != current.dd )
+            {
+                if( current.type != Paint::Type::None )
+                {
+                    NANOCANVAS_STAT(fills,1);
+                    nvgFill(m_nvgCtx);
+                }
+                current = pattern;
+                fillStyle(current);
+                NANOCANVAS_STAT(paths,1);
+                nvgBeginPath(m_nvgCtx);
+                resetPath();
+                m_path.known = false;
+            }
+            NANOCANVAS_STAT(images,1);
+            float x = dst[0];
+            float y = dst[1];
+            addHit(std::min(x,x + dst[2]),std::min(y,y + dst[3]),
+                   std::max(x,x + dst[2]),std::max(y,y + dst[3]));
+            local2Global(x,y);
+            nvgRect(m_nvgCtx,x,y,dst[2],dst[3]);
+        }
+        if( current.type != Paint::Type::None )
+        {
+            NANOCANVAS_STAT(fills,1);
+            nvgFill(m_nvgCtx);
+        }
+        restore();
+        return *this;
+    }
+
 /*------------------- State Handling -----------------*/
 
+    /// NanoVG ignores saving more states than NVG_MAX_STATES, including the current one
+    static const size_t MaxSavedStates = 31;
+
     Canvas& Canvas::save()
     {
+        if( m_stateStack.size() < MaxSavedStates )
+            m_stateStack.push_back(m_state);
         nvgSave(m_nvgCtx);
         return *this;
     }
 
     Canvas& Canvas::restore()
     {
+        if( m_stateStack.size() )
+        {
+            m_state = m_stateStack.back();
+            m_stateStack.pop_back();
+        }
         nvgRestore(m_nvgCtx);
+        transformChanged();
         return *this;
     }
 
     Canvas& Canvas::reset()
     {
         nvgReset(m_nvgCtx);
+        resetState();
+        transformChanged();
+        // The areas out of the damage must be kept
+        if( m_repainting )
+            scissorRepaintRect();
+        return *this;
+    }
+
+    Canvas& Canvas::invalidateState()
+    {
+        // The scissor may have been changed too, stop culling by the clip area
+        m_state.known = 0U;
+        m_state.clip[0] = m_state.clip[1] = -INFINITY;
+        m_state.clip[2] = m_state.clip[3] = INFINITY;
+        for( auto& state : m_stateStack )
+        {
+            state.known = 0U;
+            state.clip[0] = state.clip[1] = -INFINITY;
+            state.clip[2] = state.clip[3] = INFINITY;
+        }
         return *this;
     }
 
+    void Canvas::resetState()
+    {
+        m_state.known       = RenderState::All;
+        m_state.fillColor   = Colors::White.code();
+        m_state.strokeColor = Colors::Black.code();
+        m_state.lineWidth   = 1.0f;
+        m_state.miterLimit  = 10.0f;
+        m_state.lineCap     = NVG_BUTT;
+        m_state.lineJoin    = NVG_MITER;
+        m_state.alpha       = 1.0f;
+        m_state.fontFace    = 0;
+        m_state.fontSize    = 16.0f;
+        m_state.textAlign   = NVG_ALIGN_LEFT|NVG_ALIGN_BASELINE;
+        m_state.lineHeight  = 1.0f;
+        m_state.fontBlur    = 0.0f;
+        m_state.letterSpace = 0.0f;
+        nvgTransformIdentity(m_state.xform);
+        m_state.clip[0] = m_state.clip[1] = -INFINITY;
+        m_state.clip[2] = m_state.clip[3] = INFINITY;
+    }
+
 /*--------------------- Transformations ----------------*/
 
     Canvas& Canvas::scale(float scalewidth , float scaleheight)
     {
         nvgScale(m_nvgCtx,scalewidth,scaleheight);
+        float xform[6];
+        nvgTransformScale(xform,scalewidth,scaleheight);
+        premultiplyTransform(xform);
+        transformChanged();
         return *this;
     }
 
     Canvas& Canvas::rotate(float angle)
     {
         nvgRotate(m_nvgCtx,angle);
+        float xform[6];
+        nvgTransformRotate(xform,angle);
+        premultiplyTransform(xform);
+        transformChanged();
         return *this;
     }
 
     Canvas& Canvas::translate(float x,float y)
     {
         nvgTranslate(m_nvgCtx,x,y);
+        float xform[6];
+        nvgTransformTranslate(xform,x,y);
+        premultiplyTransform(xform);
+        transformChanged();
         return *this;
     }
 
@@ -511,6 +1522,9 @@ namespace NanoCanvas
                               float d, float e, float f)
     {
         nvgTransform(m_nvgCtx,a,b,c,d,e,f);
+        const float xform[6] = { a, b, c, d, e, f };
+        premultiplyTransform(xform);
+        transformChanged();
         return *this;
     }
 
@@ -519,21 +1533,78 @@ namespace NanoCanvas
     {
         nvgResetTransform(m_nvgCtx);
         nvgTransform(m_nvgCtx,a,b,c,d,e,f);
+        float* xform = m_state.xform;
+        xform[0] = a; xform[1] = b; xform[2] = c;
+        xform[3] = d; xform[4] = e; xform[5] = f;
+        m_state.known |= RenderState::Transform;
+        transformChanged();
         return *this;
     }
 
     Canvas& Canvas::restTransform()
     {
         nvgResetTransform(m_nvgCtx);
+        nvgTransformIdentity(m_state.xform);
+        m_state.known |= RenderState::Transform;
+        transformChanged();
         return *this;
     }
+    
+    void Canvas::premultiplyTransform(const float* xform)
+    {
+        // An unknown transform is read from NanoVG when it is needed
+        if( m_state.known & RenderState::Transform )
+            nvgTransformPremultiply(m_state.xform,xform);
+    }
+    
+    const float* Canvas::getTransform()
+    {
+        if( !( m_state.known & RenderState::Transform ) )
+        {
+            nvgCurrentTransform(m_nvgCtx,m_state.xform);
+            m_state.known |= RenderState::Transform;
+        }
+        return m_state.xform;
+    }
+    
+    void Canvas::transformPoint(float& x,float& y)
+    {
+        local2Global(x,y);
+        nvgTransformPoint(&x,&y,getTransform(),x,y);
+    }
+    
+    bool Canvas::inverseTransformPoint(float& x,float& y)
+    {
+        float inverse[6];
+        if( !nvgTransformInverse(inverse,getTransform()) )
+            return false;
+        nvgTransformPoint(&x,&y,inverse,x,y);
+        global2Local(x,y);
+        return true;
+    }
 
 /*---------------- Canvas Control -----------------*/
     Canvas& Canvas::begineFrame(int windowWidth, int windowHeight)
     {
         nvgBeginFrame(m_nvgCtx,windowWidth,windowHeight,m_scaleRatio);
+        // NanoVG starts each frame with an empty state stack and the default state
+        m_stateStack.clear();
+        resetState();
+        m_droppedStates = 0UL;
+        m_frameStats = FrameStats();
+        deleteRetiredGradients();
+        // Layers are drawn inside the frame, the scratch memory of the frame is still used
+        if( !m_layer )
+        {
+            m_arena.reset();
+            // The shapes are kept until they are drawn again
+            m_hitsExpired = true;
+            m_hitID = 0;
+        }
+        resetPath();
         // Clip out side area
         nvgScissor(m_nvgCtx,m_xPos,m_yPos,m_width,m_height);
+        NANOCANVAS_STAT(scissors,1);
 
         return *this;
     }
@@ -546,12 +1617,24 @@ namespace NanoCanvas
 
     void Canvas::endFrame()
     {
+        // Nothing was recorded in this frame
+        if( m_hitsExpired && !m_layer )
+            resetHits();
+#ifdef NANOCANVAS_FRAME_STATS
+        auto start = std::chrono::steady_clock::now();
+        nvgEndFrame(m_nvgCtx);
+        std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        m_frameStats.flushTime += time.count();
+#else
         nvgEndFrame(m_nvgCtx);
+#endif
     }
 
     Canvas& Canvas::beginPath()
     {
+        NANOCANVAS_STAT(paths,1);
         nvgBeginPath(m_nvgCtx);
+        resetPath();
         return *this;
     }
 
@@ -560,20 +1643,453 @@ namespace NanoCanvas
         int windingDir = NVG_CW;
         if ( dir == Winding::CCW)
             windingDir = NVG_CCW;
+        if( m_recordedPath )
+            m_recordedPath->pathWinding(dir);
         nvgPathWinding(m_nvgCtx, windingDir);
         return *this;
     }
 
     Canvas& Canvas::clip(float x,float y,float w,float h)
     {
+        // NanoVG intersects the scissors by their bounds in window coordinates too
+        float x0 = std::min(x,x + w), y0 = std::min(y,y + h);
+        float x1 = std::max(x,x + w), y1 = std::max(y,y + h);
+        windowBounds(x0,y0,x1,y1);
+        float* clip = m_state.clip;
+        clip[0] = std::max(clip[0],x0);
+        clip[1] = std::max(clip[1],y0);
+        clip[2] = std::min(clip[2],x1);
+        clip[3] = std::min(clip[3],y1);
         local2Global(x,y);
         nvgIntersectScissor(m_nvgCtx,x,y,w,h);
+        NANOCANVAS_STAT(scissors,1);
         return *this;
     }
 
     Canvas& Canvas::resetClip()
     {
+        // The areas out of the damage must be kept
+        if( m_repainting )
+        {
+            scissorRepaintRect();
+            return *this;
+        }
+        m_state.clip[0] = m_state.clip[1] = -INFINITY;
+        m_state.clip[2] = m_state.clip[3] = INFINITY;
         nvgResetScissor(m_nvgCtx);
+        NANOCANVAS_STAT(scissors,1);
         return *this;
     }
+
+/*---------------- Hit Testing -----------------*/
+
+    void Canvas::resetPath()
+    {
+        m_path = PathBounds();
+        if( m_recordedPath )
+            m_recordedPath->clear();
+    }
+    
+    void Canvas::addRectPath(float x,float y,float w,float h)
+    {
+        m_path.add(std::min(x,x + w),std::min(y,y + h),std::max(x,x + w),std::max(y,y + h));
+        if( Path2D* path = recordedPath() )
+            path->rect(x,y,w,h);
+    }
+    
+    Path2D* Canvas::recordedPath()
+    {
+        Path2D* path = m_recordedPath.get();
+        // The points are kept in the coordinates of the transform where the path began
+        if( path && path->empty() )
+        {
+            const float* xform = getTransform();
+            std::copy(xform,xform + 6,m_recordedTransform);
+        }
+        return path;
+    }
+    
+    void Canvas::rebaseRecordedPath()
+    {
+        Path2D& path = *m_recordedPath;
+        const float* xform = getTransform();
+        float inverse[6];
+        if( path.empty() || std::equal(xform,xform + 6,m_recordedTransform) ||
+            !nvgTransformInverse(inverse,xform) )
+            return;
+        float* bounds = path.m_bounds;
+        bounds[0] = bounds[1] = FLT_MAX;
+        bounds[2] = bounds[3] = -FLT_MAX;
+        for( size_t i = 0 ; i < path.m_points.size() ; i += 2 )
+        {
+            float& x = path.m_points[i];
+            float& y = path.m_points[i+1];
+            local2Global(x,y);
+            nvgTransformPoint(&x,&y,m_recordedTransform,x,y);
+            nvgTransformPoint(&x,&y,inverse,x,y);
+            global2Local(x,y);
+            bounds[0] = std::min(bounds[0],x);
+            bounds[1] = std::min(bounds[1],y);
+            bounds[2] = std::max(bounds[2],x);
+            bounds[3] = std::max(bounds[3],y);
+        }
+        std::copy(xform,xform + 6,m_recordedTransform);
+    }
+    
+    void Canvas::addPathHit(float reach)
+    {
+        if( !m_hitID || !m_path.known || m_path.empty() )
+            return;
+        if( std::isnan(reach) )
+            reach = 0.0f;
+        addHit(m_path.x0 - reach,m_path.y0 - reach,m_path.x1 + reach,m_path.y1 + reach);
+    }
+    
+    Canvas& Canvas::setPathRecording(bool enabled)
+    {
+        if( !enabled )
+            m_recordedPath.reset();
+        else if( !m_recordedPath )
+            m_recordedPath.reset(new Path2D());
+        return *this;
+    }
+    
+    /// Convert a point in canvas coordinates into the coordinates of a transform
+    static bool untransformPoint(const float* xform,float xPos,float yPos,float& x,float& y)
+    {
+        float inverse[6];
+        if( !nvgTransformInverse(inverse,xform) )
+            return false;
+        nvgTransformPoint(&x,&y,inverse,x + xPos,y + yPos);
+        x -= xPos;
+        y -= yPos;
+        return true;
+    }
+    
+    bool Canvas::isPointInPath(float x,float y)
+    {
+        return m_recordedPath && untransformPoint(m_recordedTransform,m_xPos,m_yPos,x,y) &&
+               m_recordedPath->contains(x,y);
+    }
+    
+    bool Canvas::isPointInPath(const Path2D& path,float x,float y)
+    {
+        return untransformPoint(getTransform(),m_xPos,m_yPos,x,y) && path.contains(x,y);
+    }
+    
+    bool Canvas::isPointInStroke(float x,float y)
+    {
+        return m_recordedPath && untransformPoint(m_recordedTransform,m_xPos,m_yPos,x,y) &&
+               m_recordedPath->strokeContains(x,y,m_state.lineWidth);
+    }
+    
+    bool Canvas::isPointInStroke(const Path2D& path,float x,float y)
+    {
+        return untransformPoint(getTransform(),m_xPos,m_yPos,x,y) &&
+               path.strokeContains(x,y,m_state.lineWidth);
+    }
+
+/*---------------- Damage Tracking -----------------*/
+
+    /// More damaged rectangles are merged into the cheapest pairs
+    static const size_t MaxDamageRects = 4;
+
+    Canvas& Canvas::invalidate(float x,float y,float w,float h)
+    {
+        DamageRect rect;
+        rect.x0 = x;
+        rect.y0 = y;
+        rect.x1 = x + w;
+        rect.y1 = y + h;
+        addDamage(rect);
+        return *this;
+    }
+
+    Canvas& Canvas::invalidate()
+    {
+        return invalidate(0,0,m_width,m_height);
+    }
+
+    /// The area of a damaged rectangle
+    static float area(float x0,float y0,float x1,float y1)
+    {
+        return ( x1 - x0 )*( y1 - y0 );
+    }
+
+    void Canvas::addDamage(DamageRect rect)
+    {
+        rect.x0 = clamp(std::floor(rect.x0),0.0f,m_width);
+        rect.y0 = clamp(std::floor(rect.y0),0.0f,m_height);
+        rect.x1 = clamp(std::ceil(rect.x1),0.0f,m_width);
+        rect.y1 = clamp(std::ceil(rect.y1),0.0f,m_height);
+        if( rect.x1 <= rect.x0 || rect.y1 <= rect.y0 )
+            return;
+
+        // Absorb the rectangles whose union wastes no area
+        for( size_t i = 0 ; i < m_damage.size() ; )
+        {
+            const DamageRect& d = m_damage[i];
+            float x0 = std::min(rect.x0,d.x0), y0 = std::min(rect.y0,d.y0);
+            float x1 = std::max(rect.x1,d.x1), y1 = std::max(rect.y1,d.y1);
+            bool overlap = rect.x0 < d.x1 && d.x0 < rect.x1 && rect.y0 < d.y1 && d.y0 < rect.y1;
+            if( overlap || area(x0,y0,x1,y1) <= area(rect.x0,rect.y0,rect.x1,rect.y1) +
+                                                 area(d.x0,d.y0,d.x1,d.y1) )
+            {
+                rect.x0 = x0;
+                rect.y0 = y0;
+                rect.x1 = x1;
+                rect.y1 = y1;
+                m_damage.erase(m_damage.begin() + i);
+                i = 0;
+            }
+            else
+                ++i;
+        }
+        m_damage.push_back(rect);
+
+        // Keep a few rectangles by merging the pair which grows the least
+        while( m_damage.size() > MaxDamageRects )
+        {
+            size_t bestI = 0,bestJ = 1;
+            float bestCost = INFINITY;
+            for( size_t i = 0 ; i < m_damage.size() ; ++i )
+            {
+                for( size_t j = i + 1 ; j < m_damage.size() ; ++j )
+                {
+                    const DamageRect& a = m_damage[i];
+                    const DamageRect& b = m_damage[j];
+                    float cost = area(std::min(a.x0,b.x0),std::min(a.y0,b.y0),
+                                      std::max(a.x1,b.x1),std::max(a.y1,b.y1)) -
+                                 area(a.x0,a.y0,a.x1,a.y1) - area(b.x0,b.y0,b.x1,b.y1);
+                    if( cost < bestCost )
+                    {
+                        bestCost = cost;
+                        bestI = i;
+                        bestJ = j;
+                    }
+                }
+            }
+            DamageRect merged = m_damage[bestI];
+            const DamageRect& other = m_damage[bestJ];
+            merged.x0 = std::min(merged.x0,other.x0);
+            merged.y0 = std::min(merged.y0,other.y0);
+            merged.x1 = std::max(merged.x1,other.x1);
+            merged.y1 = std::max(merged.y1,other.y1);
+            m_damage.erase(m_damage.begin() + bestJ);
+            m_damage.erase(m_damage.begin() + bestI);
+            addDamage(merged);
+        }
+    }
+
+    Canvas& Canvas::repaint(const std::function<void(Canvas&)>& draw)
+    {
+        // The shapes out of the damage are still on the screen
+        if( !m_layer )
+            m_hitsExpired = false;
+        // The callback may add damage for the next frame
+        size_t count = m_damage.size();
+        DamageRect* damage = m_arena.allocate<DamageRect>(count);
+        std::copy(m_damage.begin(),m_damage.end(),damage);
+        m_damage.clear();
+        for( size_t i = 0 ; i < count ; ++i )
+        {
+            const DamageRect& rect = damage[i];
+            m_repaintRect.x0 = rect.x0 + m_xPos;
+            m_repaintRect.y0 = rect.y0 + m_yPos;
+            m_repaintRect.x1 = rect.x1 + m_xPos;
+            m_repaintRect.y1 = rect.y1 + m_yPos;
+            save();
+            m_repainting = true;
+            scissorRepaintRect();
+            if( !m_layer )
+                m_hitGrid.remove(m_repaintRect.x0,m_repaintRect.y0,m_repaintRect.x1,m_repaintRect.y1);
+            draw(*this);
+            m_repainting = false;
+            restore();
+        }
+        return *this;
+    }
+
+    void Canvas::scissorRepaintRect()
+    {
+        // The scissor is set in window coordinates, the transform is kept for the pass
+        const float* xform = getTransform();
+        nvgResetTransform(m_nvgCtx);
+        nvgScissor(m_nvgCtx,m_repaintRect.x0,m_repaintRect.y0,
+                   m_repaintRect.x1 - m_repaintRect.x0,m_repaintRect.y1 - m_repaintRect.y0);
+        NANOCANVAS_STAT(scissors,1);
+        nvgTransform(m_nvgCtx,xform[0],xform[1],xform[2],xform[3],xform[4],xform[5]);
+        float* clip = m_state.clip;
+        clip[0] = m_repaintRect.x0;
+        clip[1] = m_repaintRect.y0;
+        clip[2] = m_repaintRect.x1;
+        clip[3] = m_repaintRect.y1;
+    }
+
+/*---------------- Offscreen Layers -----------------*/
+
+    bool Canvas::beginLayer(Layer& layer)
+    {
+        if( m_layer || !layer.dirty() )
+            return false;
+        // The layer is rasterized at the resolution of the canvas
+        int width = std::max(1,(int)std::ceil(layer.m_width*m_scaleRatio));
+        int height = std::max(1,(int)std::ceil(layer.m_height*m_scaleRatio));
+        if( !layer.m_renderer )
+            layer.m_renderer.reset(new SoftwareRenderer(width,height));
+        else if( layer.m_renderer->width() != width || layer.m_renderer->height() != height )
+            layer.m_renderer->resize(width,height);
+        else
+            layer.m_renderer->clear();
+        if( !layer.m_renderer->valid() )
+            return false;
+
+        // Fonts are created in the same order to get the same face ids
+        NVGcontext* ctx = layer.m_renderer->nvgContext();
+        for( ; layer.m_fonts < m_fontSources.size() ; ++layer.m_fonts )
+        {
+            const FontSource& font = m_fontSources[layer.m_fonts];
+            if( font.data )
+                nvgCreateFontMem(ctx,font.name.c_str(),(unsigned char*)font.data,font.size,0);
+            else
+                nvgCreateFont(ctx,font.name.c_str(),font.path.c_str());
+        }
+
+        m_layerParent.context = m_nvgCtx;
+        m_layerParent.width = m_width;
+        m_layerParent.height = m_height;
+        m_layerParent.scaleRatio = m_scaleRatio;
+        m_layerParent.xPos = m_xPos;
+        m_layerParent.yPos = m_yPos;
+        m_layerParent.state = m_state;
+        m_layerParent.stateStack.swap(m_stateStack);
+        m_layerParent.droppedStates = m_droppedStates;
+        m_layerParent.repainting = m_repainting;
+        m_layerParent.frameStats = m_frameStats;
+        m_layerParent.path = m_path;
+        m_layerParent.recordedPath.swap(m_recordedPath);
+        std::copy(m_recordedTransform,m_recordedTransform + 6,m_layerParent.recordedTransform);
+        if( m_layerParent.recordedPath )
+            m_recordedPath.reset(new Path2D());
+        m_gradientImages.swap(layer.m_gradientImages);
+
+        m_nvgCtx = ctx;
+        m_width = layer.m_width;
+        m_height = layer.m_height;
+        m_xPos = m_yPos = 0;
+        m_repainting = false;
+        // Compiled paints contain the position
+        m_positionEpoch = nextEpoch();
+        m_layer = &layer;
+        layer.m_missingImages = 0;
+        begineFrame(layer.m_width,layer.m_height);
+        return true;
+    }
+
+    Canvas& Canvas::endLayer()
+    {
+        if( !m_layer )
+            return *this;
+        endFrame();
+        Layer& layer = *m_layer;
+        m_layer = nullptr;
+        // The copies of canvas images are only kept while drawing
+        for( const auto& image : layer.m_images )
+            if( image.second )
+                nvgDeleteImage(m_nvgCtx,image.second);
+        layer.m_images.clear();
+
+        m_gradientImages.swap(layer.m_gradientImages);
+        m_nvgCtx = m_layerParent.context;
+        m_width = m_layerParent.width;
+        m_height = m_layerParent.height;
+        m_scaleRatio = m_layerParent.scaleRatio;
+        m_xPos = m_layerParent.xPos;
+        m_yPos = m_layerParent.yPos;
+        m_state = m_layerParent.state;
+        m_stateStack.swap(m_layerParent.stateStack);
+        m_layerParent.stateStack.clear();
+        m_droppedStates = m_layerParent.droppedStates;
+        m_repainting = m_layerParent.repainting;
+        m_path = m_layerParent.path;
+        m_recordedPath.swap(m_layerParent.recordedPath);
+        m_layerParent.recordedPath.reset();
+        std::copy(m_layerParent.recordedTransform,m_layerParent.recordedTransform + 6,m_recordedTransform);
+        m_positionEpoch = nextEpoch();
+        // The work of the layer is a part of the frame
+        const FrameStats& parent = m_layerParent.frameStats;
+        m_frameStats.paths += parent.paths;
+        m_frameStats.fills += parent.fills;
+        m_frameStats.strokes += parent.strokes;
+        m_frameStats.texts += parent.texts;
+        m_frameStats.images += parent.images;
+        m_frameStats.stateChanges += parent.stateChanges;
+        m_frameStats.scissors += parent.scissors;
+        m_frameStats.canvasTime += parent.canvasTime;
+        m_frameStats.flushTime += parent.flushTime;
+
+        int width = layer.m_renderer->width();
+        int height = layer.m_renderer->height();
+        Memery memory;
+        memory.data = (void*)layer.m_renderer->pixels();
+        memory.size = (unsigned long)width*height*4;
+        int w = 0,h = 0;
+        if( layer.m_image )
+            layer.m_image->size(w,h);
+        // The size changes with the scale ratio of the canvas too
+        if( w == width && h == height )
+            layer.m_image->update(memory);
+        else
+            layer.m_image.reset(new Image(*this,width,height,memory,Image::PreMultiplied));
+        layer.m_dirty = false;
+        return *this;
+    }
+
+    Canvas& Canvas::drawLayer(Layer& layer,float x,float y)
+    {
+        if( layer.m_image )
+            drawImage(*layer.m_image,x,y,(float)layer.m_width,(float)layer.m_height);
+        return *this;
+    }
+
+    int Canvas::layerImage(int imageID)
+    {
+        auto found = m_layer->m_images.find(imageID);
+        int copy = found != m_layer->m_images.end() ? found->second : 0;
+        if( !copy )
+            ++m_layer->m_missingImages;
+        return copy;
+    }
+
+    int Canvas::layerImage(const Image& image)
+    {
+        // Images from memory can't be created again, their data isn't kept
+        if( !m_layer->m_images.count(image.imageID) )
+            m_layer->m_images[image.imageID] = image.m_filePath.empty() ? 0 :
+                nvgCreateImage(m_nvgCtx,image.m_filePath.c_str(),image.m_imageFlags);
+        return layerImage(image.imageID);
+    }
+
+    int Canvas::layerImage(const ImageAtlas& atlas,int pageID)
+    {
+        if( !m_layer->m_images.count(pageID) )
+        {
+            int w = 0,h = 0;
+            atlas.pageSize(w,h);
+            const unsigned char* pixels = atlas.pagePixels(pageID);
+            m_layer->m_images[pageID] = pixels ?
+                nvgCreateImageRGBA(m_nvgCtx,w,h,atlas.imageFlags(),pixels) : 0;
+        }
+        return layerImage(pageID);
+    }
+
+    void Canvas::layerPaint(const Paint& paint,NVGpaint& npaint)
+    {
+        if( paint.type != Paint::Type::ImagePattern )
+            return;
+        npaint.image = layerImage(paint.imageID);
+        // A missing image is drawn transparent instead of with a texture of the layer context
+        if( !npaint.image )
+            npaint.innerColor.a = npaint.outerColor.a = 0.0f;
+    }
 }
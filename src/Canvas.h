@@ -3,10 +3,27 @@
 
 #include <functional>
 class NVGcontext;
+struct NVGpaint;
+
+#ifdef NANOCANVAS_FRAME_STATS
+    /// Count the render work of the frame
+    #define NANOCANVAS_STAT(counter,n) ( m_frameStats.counter += (n) )
+    /// Measure the time spent in the current drawing call
+    #define NANOCANVAS_TIMER FrameTimer frameTimer(*this)
+#else
+    #define NANOCANVAS_STAT(counter,n) ((void)0)
+    #define NANOCANVAS_TIMER ((void)0)
+#endif
 
 namespace NanoCanvas
 {
     using namespace TextAlign;
+    class DisplayList;
+    class Path2D;
+    struct SubImage;
+    class ImageAtlas;
+    class MappedFile;
+    class Layer;
     
     /**
      * @class Canvas
@@ -57,6 +74,14 @@ namespace NanoCanvas
          */
         Canvas(NVGcontext* ctx,float width , float height , float scaleRatio =1.0f);
         
+        /// Delete the textures baked for gradients
+        ~Canvas();
+        
+        /// Delete copy constructor
+        Canvas(const Canvas&) = delete;
+        /// Disable assignment
+        Canvas& operator=(const Canvas&) = delete;
+        
     /* ------------------- Basic Path ----------------------*/
     
         /**
@@ -217,6 +242,24 @@ namespace NanoCanvas
          */
         Canvas& stroke();
         
+        /**
+         * @brief Fills a prebuilt path
+         * @note The path replaces the current path of the canvas, also when it is culled or empty
+         * @param path The path to fill
+         * @see NanoCanvas::Path2D
+         * @return The canvas to fill
+         */
+        Canvas& fill(const Path2D& path);
+        
+        /**
+         * @brief Strokes a prebuilt path
+         * @note The path replaces the current path of the canvas, also when it is culled or empty
+         * @param path The path to stroke
+         * @see NanoCanvas::Path2D
+         * @return The canvas to stroke
+         */
+        Canvas& stroke(const Path2D& path);
+        
         /**
          * @brief Draws a "filled" rectangle
          * 
@@ -243,6 +286,39 @@ namespace NanoCanvas
          */
         Canvas& strokeRect(float x,float y,float w,float h);
         
+        /**
+         * @brief Draws many "filled" rectangles with the current fill style
+         * 
+         * All the rectangles are submitted as one path, so they cost a single fill for the backend.
+         * 
+         * @param xywh The array of count*4 values: x, y, width and height of each rectangle
+         * @param count The count of rectangles
+         * @return The canvas to draw
+         */
+        Canvas& fillRects(const float* xywh,size_t count);
+        
+        /**
+         * @brief Draws many "filled" rectangles with their own colors
+         * 
+         * Consecutive rectangles with the same color are submitted as one path,
+         * sort the rectangles by color when the drawing order does not matter to get the fewest fills.
+         * @note The fill style is left as the color of the last rectangle
+         * 
+         * @param xywh The array of count*4 values: x, y, width and height of each rectangle
+         * @param colors The array of count colors
+         * @param count The count of rectangles
+         * @return The canvas to draw
+         */
+        Canvas& fillRects(const float* xywh,const Color* colors,size_t count);
+        
+        /**
+         * @brief Draws many rectangles (no fill) with the current stroke style
+         * @param xywh The array of count*4 values: x, y, width and height of each rectangle
+         * @param count The count of rectangles
+         * @return The canvas to draw
+         */
+        Canvas& strokeRects(const float* xywh,size_t count);
+        
         /**
          * @brief Clear the canvas with color
          * @param color The color to fill the hole canvas
@@ -261,6 +337,69 @@ namespace NanoCanvas
          */
         Canvas& fillText(const string& text,float x,float y,float rowWidth = NAN);
         
+        /**
+         * @brief Draws "filled" null-terminated text without copying it
+         * @see fillText(const string&,float,float,float)
+         */
+        Canvas& fillText(const char* text,float x,float y,float rowWidth = NAN);
+        
+        /**
+         * @brief Draws "filled" text in a range of characters without copying it
+         * @param text The first character of the text
+         * @param end The end of the text, nullptr if the text is null-terminated
+         * @param x The x coordinate where to start painting the text (relative to the canvas)
+         * @param y The y coordinate where to start painting the text (relative to the canvas)
+         * @param rowWidth The max row width of the text box,NAN is not limited
+         * @return The canvas to operate with
+         */
+        Canvas& fillText(const char* text,const char* end,float x,float y,float rowWidth = NAN);
+        
+        /**
+         * @brief Draws "filled" text laid out with its own style
+         * 
+         * The text style of the layout becomes the current text style and fill color.
+         * The text is not submitted at all when its cached bounds are out of the canvas.
+         * 
+         * @param layout The text layout to draw
+         * @param x The x coordinate where to start painting the text (relative to the canvas)
+         * @param y The y coordinate where to start painting the text (relative to the canvas)
+         * @see NanoCanvas::TextLayout
+         * @return The canvas to operate with
+         */
+        Canvas& fillText(const TextLayout& layout,float x,float y);
+        
+        /**
+         * @brief Draws "filled" wrapped text with its own style
+         * 
+         * The text style of the box becomes the current text style and fill color.
+         * Rows out of the canvas are not submitted.
+         * 
+         * @param box The text box to draw
+         * @param x The x coordinate of the left side of the box (relative to the canvas)
+         * @param y The y coordinate of the first row (relative to the canvas)
+         * @see NanoCanvas::TextBox
+         * @return The canvas to operate with
+         */
+        Canvas& fillText(const TextBox& box,float x,float y);
+        
+        /**
+         * @brief Draws "filled" number formatted without heap allocations
+         * 
+         * The width of the number is summed from advances of characters cached for the current
+         * font face, size and letter spacing, so NanoVG doesn't measure it again to align it
+         * and numbers out of the canvas are not submitted.
+         * Kerning between the characters is ignored by the alignment, fonts whose digits kern
+         * may be misaligned by a fraction of a pixel.
+         * 
+         * @param value The number to draw
+         * @param format The format of the number
+         * @param x The x coordinate where to start painting the text (relative to the canvas)
+         * @param y The y coordinate where to start painting the text (relative to the canvas)
+         * @see NanoCanvas::NumberFormat
+         * @return The canvas to operate with
+         */
+        Canvas& fillNumber(double value,const NumberFormat& format,float x,float y);
+        
         /**
          * @brief Draws an image onto the canvas
          * 
@@ -282,6 +421,44 @@ namespace NanoCanvas
                           float sx = 0,float sy = 0,
                           float swidth = NAN,float sheight = NAN);
         
+        /**
+         * @brief Draws an image packed in an atlas onto the canvas
+         * 
+         * The coordinates of the clipped area are relative to the packed image, not to the atlas page.
+         * 
+         * @param image Specifies the packed image to use
+         * @param x The x coordinate where to place the image on the canvas
+         * @param y The y coordinate where to place the image on the canvas
+         * @param width The width of the image to use (stretch or reduce the image),NAN as the default be the same as wdith of the clipped area  
+         * @param height The height of the image to use (stretch or reduce the image),NAN as the default be the same as wdith of the clipped area 
+         * @param sx The x coordinate where to start clipping,0 as the default
+         * @param sy The y coordinate where to start clipping,0 as the default
+         * @param swidth The wdith of the clipped image,NAN as defualt to clip to right side of the image
+         * @param sheight The height of the clipped image,NAN as defualt to clip to bottom side of the image
+         * @see NanoCanvas::ImageAtlas
+         * @return The canvas to draw this image
+         */
+        Canvas& drawImage(const SubImage& image,float x,float y, 
+                          float width = NAN,float height = NAN,
+                          float sx = 0,float sy = 0,
+                          float swidth = NAN,float sheight = NAN);
+        
+        /**
+         * @brief Draws many parts of an image atlas with a single state setup
+         * 
+         * Unlike calling drawImage() for each sprite, no scissor is changed and the render state
+         * is saved only once. Consecutive sprites with the same mapping of the atlas share one fill.
+         * 
+         * @param atlas The image which contains all the sprites
+         * @param src The array of count*4 values: x, y, width and height of each sprite in the atlas
+         * @param dst The array of count*4 values: x, y, width and height where to draw each sprite on the canvas
+         * @param count The count of sprites
+         * @param alpha The array of count transparent values of sprites, nullptr to draw all sprites opaque
+         * @return The canvas to draw the sprites
+         */
+        Canvas& drawImages(const Image& atlas,const float* src,const float* dst,
+                           size_t count,const float* alpha = nullptr);
+        
     /*-------------------- Style Control -------------------*/
     
         /**
@@ -355,6 +532,29 @@ namespace NanoCanvas
          */
         Canvas& strokeStyle(const Paint& paint);
         
+        /**
+         * @brief Set the compiled gradient or pattern paint used to fill the drawing
+         * @param paint The compiled paint used to fill the drawing
+         * @see Canvas::compilePaint
+         * @return The canvas to operate with
+         */
+        Canvas& fillStyle(const CompiledPaint& paint);
+        
+        /**
+         * @brief Set the compiled gradient or pattern paint used for strokes
+         * @param paint The compiled paint used for strokes
+         * @see Canvas::compilePaint
+         * @return The canvas to operate with
+         */
+        Canvas& strokeStyle(const CompiledPaint& paint);
+        
+        /**
+         * @brief Resolve a paint once to use it many times
+         * @param paint The gradient or pattern paint to compile
+         * @return The paint ready for this canvas
+         */
+        CompiledPaint compilePaint(const Paint& paint);
+        
         
         /**
          * @brief Set current font for text rendering 
@@ -403,6 +603,16 @@ namespace NanoCanvas
         static Paint createLinearGradient(float x0,float y0,float x1,float y1,
                                       const Color& scolor , const Color& ecolor);
         
+        /**
+         * @brief Creates a linear gradient without colors, add colors by Paint::addColorStop
+         * @param x0 The x-coordinate of the start point of the gradient
+         * @param y0 The y-coordinate of the start point of the gradient
+         * @param x1 The x-coordinate of the end point of the gradient
+         * @param y1 The y-coordinate of the end point of the gradient
+         * @return The created gradient style object.
+         */
+        static Paint createLinearGradient(float x0,float y0,float x1,float y1);
+        
         /**
          * @brief Creates a radial/circular gradient (to use on canvas content)
          * @param cx The x-coordinate of the circle of the gradient
@@ -415,6 +625,27 @@ namespace NanoCanvas
          */
         static Paint createRadialGradient(float cx,float cy,float r1,float r2,
                                       const Color& icolor , const Color& ocolor);
+        
+        /**
+         * @brief Creates a radial/circular gradient without colors, add colors by Paint::addColorStop
+         * @param cx The x-coordinate of the circle of the gradient
+         * @param cy The y-coordinate of the circle of the gradient
+         * @param r1 The radius of the inner circle
+         * @param r2 The radius of the outter circle
+         * @return The created gradient style object.
+         */
+        static Paint createRadialGradient(float cx,float cy,float r1,float r2);
+        
+        /**
+         * @brief Get the texture baked for the color stops of a gradient
+         * 
+         * Linear gradients are baked into a 256x1 ramp, radial gradients into a 256x256 disc.
+         * Each distinct list of stops is baked once and cached by the canvas.
+         * 
+         * @param gradient The linear or radial gradient with color stops
+         * @return The NanoVG image id of the texture, 0 if the gradient has no color stops
+         */
+        int gradientImage(const Paint& gradient);
                                       
         /**
          * @brief Creates and returns a box gradient.
@@ -446,6 +677,21 @@ namespace NanoCanvas
         static Paint createPattern(const Image& image,float ox, float oy, 
                                    float w, float h,float angle = 0.0f, float alpha = 1.0f);
         
+        /**
+         * @brief Creates and returns an image pattern paint of an image packed in an atlas.
+         * @note The pattern doesn't repeat, the area out of the packed image shows its neighbours in the atlas
+         * @param image Specifies the packed image of the pattern to use
+         * @param ox The x-coordinate of the upper-left corner of the image would be draw
+         * @param oy The y-coordinate of the upper-left corner of the image would be draw
+         * @param w The width of the pattern
+         * @param h The height of the pattern
+         * @param angle The rotation around the top-left corner in radians
+         * @param alpha The transparent of the image pattern
+         * @return The patter paint created, its type is Paint::Type::None if the image is not found
+         */
+        static Paint createPattern(const SubImage& image,float ox, float oy, 
+                                   float w, float h,float angle = 0.0f, float alpha = 1.0f);
+        
         /**
          * @brief Check the width of the text, before writing it on the canvas
          * @param text The text to be measured
@@ -465,6 +711,67 @@ namespace NanoCanvas
          */
         float measureText(const string& text,float x,float y,float* bounds,float rowWidth = NAN);
         
+        /**
+         * @brief Check the width of null-terminated text without copying it
+         * @see measureText(const string&,float)
+         */
+        float measureText(const char* text,float rowWidth = NAN);
+        
+        /**
+         * @brief Check the width of text in a range of characters without copying it
+         * @param text The first character of the text
+         * @param end The end of the text, nullptr if the text is null-terminated
+         * @param rowWidth The max row width of the text box,NAN is not limited
+         * @return The width of the specified text
+         */
+        float measureText(const char* text,const char* end,float rowWidth = NAN);
+        
+        /**
+         * @brief Check the boundary of null-terminated text without copying it
+         * @see measureText(const string&,float,float,float*,float)
+         */
+        float measureText(const char* text,float x,float y,float* bounds,float rowWidth = NAN);
+        
+        /**
+         * @brief Check the boundary of text in a range of characters without copying it
+         * @param text The first character of the text
+         * @param end The end of the text, nullptr if the text is null-terminated
+         * @param x The x-coordinate of the text
+         * @param y The y-coordinate of the text 
+         * @param bounds [in] The float array to store boundary values should be a pointer to float[4]
+         * @param rowWidth The max row width of the text box,NAN is not limited
+         * @return The width of the specified text
+         */
+        float measureText(const char* text,const char* end,float x,float y,float* bounds,
+                          float rowWidth = NAN);
+        
+        /**
+         * @brief Get the width of a text layout, it is laid out only if not measured yet
+         * @param layout The text layout to be measured
+         * @return The width of the text layout
+         */
+        float measureText(const TextLayout& layout);
+        
+        /**
+         * @brief Get the boundary of a text layout, it is laid out only if not measured yet
+         * @param layout The text layout to be measured
+         * @param x The x-coordinate of the text
+         * @param y The y-coordinate of the text 
+         * @param bounds [in] The float array to store boundary values should be a pointer to float[4]
+         * @return The width of the text layout
+         */
+        float measureText(const TextLayout& layout,float x,float y,float* bounds);
+        
+        /**
+         * @brief Get the boundary of a text box, it is wrapped only if not measured yet
+         * @param box The text box to be measured
+         * @param x The x-coordinate of the left side of the box
+         * @param y The y-coordinate of the first row
+         * @param bounds [in] The float array to store boundary values should be a pointer to float[4]
+         * @return The width of the wrapped text
+         */
+        float measureText(const TextBox& box,float x,float y,float* bounds);
+        
         
     /*--------------------- Transformations ----------------*/
         
@@ -541,6 +848,31 @@ namespace NanoCanvas
          */
         Canvas& restTransform();
         
+        /**
+         * @brief Get the current transformation matrix
+         * 
+         * The canvas keeps a copy of the matrix stack, so it is read without asking NanoVG.
+         * The matrix maps window coordinates, the position of the canvas is added before it.
+         * @return The float array of [a,b,c,d,e,f]
+         * @see Canvas::transform()
+         */
+        const float* getTransform();
+        
+        /**
+         * @brief Convert a point in canvas coordinates to window coordinates with the current transform
+         * @param x [inout] The x-coordinate to convert
+         * @param y [inout] The y-coordinate to convert
+         */
+        void transformPoint(float& x,float& y);
+        
+        /**
+         * @brief Convert a point in window coordinates to canvas coordinates with the current transform
+         * @param x [inout] The x-coordinate to convert
+         * @param y [inout] The y-coordinate to convert
+         * @return False if the transform can't be inverted, the point is not changed
+         */
+        bool inverseTransformPoint(float& x,float& y);
+        
     /*--------------------- Canvas Control -----------------*/
         /**
          * @brief Begin drawing a new frame
@@ -590,6 +922,7 @@ namespace NanoCanvas
         
         /**
          * @brief Reset clip state ,remove all clip region
+         * @note In a repaint() pass drawing stays clipped to the damaged rectangle
          * @return The canvas to reset
          */
         Canvas& resetClip();
@@ -619,10 +952,240 @@ namespace NanoCanvas
         
         /**
          * @brief Resets current render state to default values. Does not affect the render state stack.
+         * @note In a repaint() pass drawing stays clipped to the damaged rectangle
          * @return The canvas to reset state
          */
         Canvas& reset();
         
+        /**
+         * @brief Forget the shadow copy of the render state
+         * 
+         * The canvas keeps a copy of the render state to drop changes which set the current values again.
+         * Call it after changing the state of the NanoVG context directly.
+         * Draws are no longer culled by the clip area set before, as the scissor is unknown.
+         * @return The canvas to operate with
+         */
+        Canvas& invalidateState();
+        
+        /**
+         * @brief Get how many redundant state changes were dropped
+         * @return The count of dropped state changes since the frame began
+         */
+        inline unsigned long droppedStateChanges()const { return m_droppedStates; }
+        
+        /**
+         * @brief Get the scratch memory of the current frame
+         * 
+         * The memory allocated from the arena is released by the next begineFrame.
+         * @return The arena of the current frame
+         */
+        inline FrameArena& frameArena(){ return m_arena; }
+        
+    /*--------------------- Hit Testing -------------------*/
+    
+        /**
+         * @brief Keep a flattened copy of the current path for isPointInPath() and isPointInStroke()
+         * 
+         * Recording flattens the curves of each path, so it is disabled by default.
+         * It starts with the next path.
+         * @param enabled Record the current path or not
+         * @return The canvas to operate with
+         */
+        Canvas& setPathRecording(bool enabled);
+        
+        /// Check is the current path recorded
+        inline bool pathRecording()const { return m_recordedPath != nullptr; }
+        
+        /**
+         * @brief Check is a point inside the current path
+         * @param x The x-coordinate of the point, not affected by the current transform
+         * @param y The y-coordinate of the point, not affected by the current transform
+         * @return False if the path is not recorded
+         * @see Canvas::setPathRecording
+         */
+        bool isPointInPath(float x,float y);
+        
+        /**
+         * @brief Check is a point inside a path drawn with the current transform
+         * @param path The path to test
+         * @param x The x-coordinate of the point, not affected by the current transform
+         * @param y The y-coordinate of the point, not affected by the current transform
+         * @return True if the point is in the filled area of the path
+         */
+        bool isPointInPath(const Path2D& path,float x,float y);
+        
+        /**
+         * @brief Check is a point on the stroke of the current path with the current line width
+         * @param x The x-coordinate of the point, not affected by the current transform
+         * @param y The y-coordinate of the point, not affected by the current transform
+         * @return False if the path is not recorded
+         * @see Canvas::setPathRecording
+         */
+        bool isPointInStroke(float x,float y);
+        
+        /**
+         * @brief Check is a point on the stroke of a path drawn with the current transform and line width
+         * @param path The path to test
+         * @param x The x-coordinate of the point, not affected by the current transform
+         * @param y The y-coordinate of the point, not affected by the current transform
+         * @return True if the point is on the stroke of the path
+         */
+        bool isPointInStroke(const Path2D& path,float x,float y);
+        
+        /**
+         * @brief Set the id recorded with the bounds of the following drawings
+         * 
+         * The bounds of the shapes, text and images drawn with an id are indexed in a grid until the
+         * canvas is drawn again, to find the shape under the mouse without scanning all of them.
+         * The grid is replaced by the first drawing with an id of a frame, or at endFrame() if none.
+         * A frame calling repaint() keeps it, the shapes in the damaged areas are recorded again.
+         * @code
+         * for( size_t i = 0 ; i < bars.size() ; ++i )
+         *     canvas.setHitID(i + 1).fillRect(bars[i].x,bars[i].y,bars[i].w,bars[i].h);
+         * canvas.setHitID(0);
+         * // In the mouse move handler
+         * unsigned bar = canvas.hitTest(mouseX,mouseY);
+         * @endcode
+         * @note Paths using arcTo() or built across transform changes have unknown bounds and are not recorded.
+         * Layers are not recorded.
+         * @param id The id of the drawings, 0 to stop recording
+         * @return The canvas to operate with
+         */
+        inline Canvas& setHitID(unsigned id)
+        {
+            m_hitID = id;
+            return *this;
+        }
+        
+        /// The id recorded with the following drawings
+        inline unsigned hitID()const { return m_hitID; }
+        
+        /**
+         * @brief Find the topmost drawing whose bounds contain a point
+         * @param x The x-coordinate of the point in the canvas
+         * @param y The y-coordinate of the point in the canvas
+         * @return The id of the drawing, 0 if there is none
+         * @see Canvas::setHitID
+         */
+        inline unsigned hitTest(float x,float y)const
+        {
+            return m_hitGrid.query(x + m_xPos,y + m_yPos);
+        }
+        
+    /*--------------------- Frame Statistics -------------------*/
+    
+        /// The render work sent to NanoVG in a frame
+        struct FrameStats
+        {
+            /// The count of paths begun
+            unsigned long paths         = 0UL;
+            /// The count of fills
+            unsigned long fills         = 0UL;
+            /// The count of strokes
+            unsigned long strokes       = 0UL;
+            /// The count of text runs
+            unsigned long texts         = 0UL;
+            /// The count of images drawn
+            unsigned long images        = 0UL;
+            /// The count of state changes not dropped
+            unsigned long stateChanges  = 0UL;
+            /// The count of scissor changes
+            unsigned long scissors      = 0UL;
+            /// Seconds spent in the drawing calls of the canvas
+            double canvasTime           = 0.0;
+            /// Seconds spent in nvgEndFrame
+            double flushTime            = 0.0;
+        };
+        
+        /**
+         * @brief Get the statistics collected since begineFrame
+         * 
+         * After endFrame it holds the whole frame, including the layers drawn in it.
+         * @note The statistics are collected only when NanoCanvas is compiled with
+         * NANOCANVAS_FRAME_STATS defined, otherwise all values are 0.
+         * @return The statistics of the current frame
+         */
+        inline const FrameStats& frameStats()const { return m_frameStats; }
+        
+    /*--------------------- Damage Tracking -------------------*/
+    
+        /**
+         * @brief Mark an area of the canvas to be repainted
+         * 
+         * Damaged areas are merged into a few rectangles, which are repainted by repaint().
+         * @param x The x-coordinate of the upper-left corner of the area
+         * @param y The y-coordinate of the upper-left corner of the area
+         * @param w The width of the area, in pixels
+         * @param h The height of the area, in pixels
+         * @return The canvas to operate with
+         */
+        Canvas& invalidate(float x,float y,float w,float h);
+        
+        /**
+         * @brief Mark the whole canvas to be repainted
+         * @return The canvas to operate with
+         */
+        Canvas& invalidate();
+        
+        /// Check is any area of the canvas waiting for repaint
+        inline bool damaged()const { return m_damage.size(); }
+        
+        /**
+         * @brief Repaint the damaged areas and keep the rest of the previous frame
+         * 
+         * The draw function is called once for each damaged rectangle, with drawing scissored to it.
+         * Shapes with known bounds, like rectangles, images and text layouts, out of the rectangle are skipped.
+         * clearColor() only clears the rectangle in a repaint pass.
+         * The damage is cleared after repainting.
+         * @note Call it between begineFrame() and endFrame(). The backend must preserve the framebuffer
+         * between frames, for example the SoftwareRenderer does.
+         * @param draw The function to draw the whole canvas
+         * @return The canvas to operate with
+         */
+        Canvas& repaint(const std::function<void(Canvas&)>& draw);
+        
+    /*--------------------- Offscreen Layers -------------------*/
+    
+        /**
+         * @brief Begin drawing into an offscreen layer if its content is invalidated
+         * 
+         * Until endLayer() is called, drawing goes to the layer, whose upper-left corner is the origin.
+         * The render state of the canvas is kept and restored by endLayer().
+         * @param layer The layer to draw
+         * @return True if the layer needs drawing, the drawing must be ended by endLayer().
+         * False if the layer is up to date, or another layer is being drawn.
+         * @see NanoCanvas::Layer
+         */
+        bool beginLayer(Layer& layer);
+        
+        /**
+         * @brief End drawing an offscreen layer and update its image
+         * @return The canvas to operate with
+         */
+        Canvas& endLayer();
+        
+        /**
+         * @brief Draw the image of a layer at its size in canvas units
+         * @param layer The layer to draw, nothing is drawn until it has an image
+         * @param x The x coordinate where to place the layer on the canvas
+         * @param y The y coordinate where to place the layer on the canvas
+         * @return The canvas to operate with
+         */
+        Canvas& drawLayer(Layer& layer,float x,float y);
+        
+    /*--------------------- Display List -------------------*/
+    
+        /**
+         * @brief Submit all the commands recorded in a display list
+         * 
+         * The recorded calls are replayed in order as if they were called on this canvas.
+         * The coordinates are relative to the current canvas position.
+         * 
+         * @param list The display list to replay
+         * @see NanoCanvas::DisplayList
+         * @return The canvas to operate with
+         */
+        Canvas& replay(const DisplayList& list);
         
     /*------------------ Canvas propoties ---------------------*/
     
@@ -655,6 +1218,8 @@ namespace NanoCanvas
         {
             m_xPos = x;
             m_yPos = y;
+            // Compiled paints contain the position
+            m_positionEpoch = nextEpoch();
             return *this;
         }
         
@@ -700,11 +1265,346 @@ namespace NanoCanvas
         
         /**
          * @brief Get the NanoVG context for advanced contol
-         * @return The NanoVG context of this canvas
+         * @return The NanoVG context of this canvas, the offscreen one while a layer is drawn
          */
         NVGcontext* nvgContext(){ return m_nvgCtx; }
         
+        /**
+         * @brief Get the NanoVG context the images and textures of the canvas belong to
+         * @return The NanoVG context of this canvas, even while a layer is drawn
+         */
+        inline NVGcontext* imageContext(){ return m_layer ? m_layerParent.context : m_nvgCtx; }
+        
     protected:
+        friend struct Font;
+        friend class Layer;
+        
+        /// The shadow copy of the NanoVG render state
+        struct RenderState
+        {
+            /// Bits of the fields whose values are known
+            enum Field : unsigned
+            {
+                FillColor   = 1<<0,
+                StrokeColor = 1<<1,
+                LineWidth   = 1<<2,
+                MiterLimit  = 1<<3,
+                LineCap     = 1<<4,
+                LineJoin    = 1<<5,
+                Alpha       = 1<<6,
+                FontFace    = 1<<7,
+                FontSize    = 1<<8,
+                TextAlign   = 1<<9,
+                LineHeight  = 1<<10,
+                FontBlur    = 1<<11,
+                LetterSpace = 1<<12,
+                Transform   = 1<<13,
+                All         = (1<<14) - 1
+            };
+            unsigned known      = 0U;
+            unsigned fillColor  = 0U;
+            unsigned strokeColor= 0U;
+            float lineWidth     = 0.0f;
+            float miterLimit    = 0.0f;
+            int lineCap         = 0;
+            int lineJoin        = 0;
+            float alpha         = 0.0f;
+            int fontFace        = 0;
+            float fontSize      = 0.0f;
+            int textAlign       = 0;
+            float lineHeight    = 0.0f;
+            float fontBlur      = 0.0f;
+            float letterSpace   = 0.0f;
+            /// The transformation matrix
+            float xform[6]      = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+            /// The bounds of the clip area in window coordinates, infinite if not clipped
+            float clip[4]       = { -INFINITY, -INFINITY, INFINITY, INFINITY };
+        };
+        
+        /// Conservative bounds of the current path in canvas coordinates
+        struct PathBounds
+        {
+            float x0    = INFINITY;
+            float y0    = INFINITY;
+            float x1    = -INFINITY;
+            float y1    = -INFINITY;
+            /// False if the bounds can't be trusted, the transform was changed while building the path
+            bool known  = true;
+            
+            inline bool empty()const { return x0 > x1; }
+            
+            inline void add(float minx,float miny,float maxx,float maxy)
+            {
+                x0 = std::min(x0,minx);
+                y0 = std::min(y0,miny);
+                x1 = std::max(x1,maxx);
+                y1 = std::max(y1,maxy);
+            }
+        };
+        
+        /**
+         * @brief Update a field of the shadow render state
+         * @return True if the value is changed and should be sent to NanoVG
+         */
+        template<typename T>
+        inline bool changeState(unsigned field,T& current,const T& value)
+        {
+            if( ( m_state.known & field ) && current == value )
+            {
+                ++m_droppedStates;
+                return false;
+            }
+            current = value;
+            m_state.known |= field;
+            NANOCANVAS_STAT(stateChanges,1);
+            return true;
+        }
+        
+        /// Set the shadow render state to the defaults of NanoVG
+        void resetState();
+        
+        /// Multiply the shadow transform by a matrix applied before it
+        void premultiplyTransform(const float* xform);
+        
+        /// Set the font face by id
+        void fontFace(int face);
+        
+        /// The textures baked for color stops of gradients in a context, keyed by their content
+        struct GradientCache
+        {
+            /// A baked texture
+            struct Entry
+            {
+                string key;
+                int image;
+                size_t bytes;
+            };
+            /// Entries from the most recently used to the least
+            std::list<Entry> entries;
+            /// Entries indexed by key
+            std::unordered_map<string,std::list<Entry>::iterator> index;
+            size_t bytes = 0;
+            /// Textures evicted in this frame, they are deleted when the next frame begins
+            std::vector<int> retired;
+            
+            /// Exchange the textures with another context, the iterators stay valid
+            inline void swap(GradientCache& other)
+            {
+                entries.swap(other.entries);
+                index.swap(other.index);
+                std::swap(bytes,other.bytes);
+                retired.swap(other.retired);
+            }
+        };
+        
+        /// Delete the textures evicted from the gradient cache in the previous frame
+        void deleteRetiredGradients();
+        
+        /// The source of a font, to create it again in offscreen contexts
+        struct FontSource
+        {
+            string name;
+            string path;
+            const unsigned char * data;
+            unsigned long size;
+        };
+        
+        /// The canvas state kept while drawing a layer
+        struct LayerParent
+        {
+            NVGcontext * context;
+            float width;
+            float height;
+            float scaleRatio;
+            float xPos;
+            float yPos;
+            RenderState state;
+            std::vector<RenderState> stateStack;
+            unsigned long droppedStates;
+            bool repainting;
+            FrameStats frameStats;
+            /// The path being built when the layer began
+            PathBounds path;
+            std::unique_ptr<Path2D> recordedPath;
+            float recordedTransform[6];
+        };
+        
+#ifdef NANOCANVAS_FRAME_STATS
+        /// Measure the time spent in a drawing call, nested calls are measured once
+        struct FrameTimer
+        {
+            FrameTimer(Canvas& canvas) : m_canvas(canvas)
+            {
+                if( !m_canvas.m_timerDepth++ )
+                    m_start = std::chrono::steady_clock::now();
+            }
+            
+            ~FrameTimer()
+            {
+                if( !--m_canvas.m_timerDepth )
+                {
+                    std::chrono::duration<double> time = std::chrono::steady_clock::now() - m_start;
+                    m_canvas.m_frameStats.canvasTime += time.count();
+                }
+            }
+            
+            Canvas& m_canvas;
+            std::chrono::steady_clock::time_point m_start;
+        };
+#endif
+        
+        /// A damaged area in canvas coordinates
+        struct DamageRect
+        {
+            float x0,y0,x1,y1;
+        };
+        
+        /// Merge a damaged area into the damage rectangles
+        void addDamage(DamageRect rect);
+        
+        /**
+         * @brief Draw a position epoch from a counter shared by all the canvases
+         *
+         * A canvas at the address of a destroyed one never reuses its epochs,
+         * so the compiled paints of the old canvas are resolved again.
+         */
+        static unsigned long nextEpoch();
+        
+        /// Convert the source of a compiled paint for the current position of this canvas
+        void resolvePaint(const CompiledPaint& paint);
+        
+        /// Set a compiled paint to fill or stroke with, it is resolved again if the canvas moved
+        void applyPaint(const CompiledPaint& paint,bool stroke);
+        
+        /// Get the copy of a canvas image in the layer being drawn, 0 if the image wasn't copied
+        int layerImage(int imageID);
+        
+        /// Get the copy of an image loaded from a file in the layer being drawn, 0 if it can't be loaded
+        int layerImage(const Image& image);
+        
+        /// Get the copy of an atlas page in the layer being drawn, 0 if it can't be created
+        int layerImage(const ImageAtlas& atlas,int pageID);
+        
+        /// Map the image of a pattern to its copy in the layer being drawn, hide the pattern if there is none
+        void layerPaint(const Paint& paint,NVGpaint& npaint);
+        
+        /// Apply the font and the alignment of a text style, the unset fields are kept
+        void applyTextStyle(const TextStyle& textStyle);
+        
+        /// Replace current path with the flattened points of a path
+        void addPath(const Path2D& path);
+        
+        /// Resolve the font state a text style lays out with on this canvas
+        void textMetricsKey(const TextStyle& style,TextMetricsKey& key);
+        
+        /// Compute the metrics of a text layout if they aren't computed with the same font state
+        void layoutText(const TextLayout& layout);
+        
+        /// Compute the rows of a text box if they aren't computed with the same font state
+        void layoutText(const TextBox& box);
+        
+        /// The advances of ASCII characters in a font face, size and letter spacing
+        struct CharAdvances
+        {
+            int face;
+            float size;
+            float letterSpace;
+            /// The scale the glyphs are rasterized at, their advances are rounded at that size
+            float scale;
+            /// The line height to bound the text vertically
+            float lineHeight;
+            /// The advances measured, NAN for the characters not measured yet
+            float advance[128];
+        };
+        
+        /**
+         * @brief Get the character advances of the current text style
+         * @return The cached advances, nullptr if the text style isn't known
+         */
+        CharAdvances* charAdvances();
+        
+        /**
+         * @brief Check is a box in canvas coordinates out of the canvas after the current transform
+         * 
+         * The box is tested against the canvas, the clip area and the area being repainted.
+         * @return True if nothing in the box can be visible
+         */
+        bool rejected(float minx,float miny,float maxx,float maxy);
+        
+        /// Convert a box in canvas coordinates to its bounding box in window coordinates
+        void windowBounds(float& minx,float& miny,float& maxx,float& maxy);
+        
+        /// Check is the current path out of the canvas, reach is how far its stroke extends
+        bool pathRejected(float reach);
+        
+        /// How far a stroke can extend out of its path, NAN if the stroke style is unknown
+        float strokeReach()const;
+        
+        /// Check is a text run surely out of the canvas without measuring it
+        bool textRejected(const char* text,const char* end,float x,float y,float rowWidth);
+        
+        /// Forget the bounds of the current path if the transform changed while building it
+        inline void transformChanged()
+        {
+            if( !m_path.empty() )
+                m_path.known = false;
+            if( m_recordedPath )
+                rebaseRecordedPath();
+        }
+        
+        /// Start a new current path
+        void resetPath();
+        
+        /// Add a rectangle to the bounds and the recorded copy of the current path
+        void addRectPath(float x,float y,float w,float h);
+        
+        /// Get the recorded copy of the current path to add to, nullptr if not recording
+        Path2D* recordedPath();
+        
+        /// Move the recorded path into the coordinates of the current transform
+        void rebaseRecordedPath();
+        
+        /// Clip to the rectangle being repainted alone, keeping the current transform
+        void scissorRepaintRect();
+        
+        /// Replace the shapes of the previous frame in the hit grid
+        inline void resetHits()
+        {
+            m_hitGrid.reset(m_xPos,m_yPos,m_width,m_height);
+            m_hitsExpired = false;
+        }
+        
+        /// Record the bounds of a drawing in canvas coordinates with the current hit id
+        inline void addHit(float minx,float miny,float maxx,float maxy)
+        {
+            if( m_hitID && !m_layer )
+            {
+                if( m_hitsExpired )
+                    resetHits();
+                windowBounds(minx,miny,maxx,maxy);
+                // Shapes out of the repainted area are still in the grid
+                if( m_repainting && ( maxx < m_repaintRect.x0 || maxy < m_repaintRect.y0 ||
+                                      minx > m_repaintRect.x1 || miny > m_repaintRect.y1 ) )
+                    return;
+                m_hitGrid.insert(minx,miny,maxx,maxy,m_hitID);
+            }
+        }
+        
+        /// Record the bounds of the current path, reach is how far its stroke extends
+        void addPathHit(float reach);
+        
+        /**
+         * @brief Draw a clipped area of an image stored in a texture
+         * @param imageID The NanoVG image id of the texture
+         * @param textureWidth The width of the texture
+         * @param textureHeight The height of the texture
+         * @param region The float array of [x,y,width,height] of the image in the texture
+         * @see Canvas::drawImage()
+         */
+        void drawImageRegion(int imageID,int textureWidth,int textureHeight,const float* region,
+                             float x,float y,float width,float height,
+                             float sx,float sy,float swidth,float sheight);
+        
         /// The NanoVG context
         NVGcontext * m_nvgCtx;
         /// The width of the canvas
@@ -717,6 +1617,54 @@ namespace NanoCanvas
         float m_xPos;
         /// The y-coordinate of the canvas in window
         float m_yPos;
+        /// The fonts created for this canvas in order
+        std::vector<FontSource> m_fontSources;
+        /// The layer being drawn
+        Layer * m_layer = nullptr;
+        /// The canvas state kept while drawing a layer
+        LayerParent m_layerParent;
+        /// The damaged areas waiting for repaint
+        std::vector<DamageRect> m_damage;
+        /// The damaged area being repainted in window coordinates, not used out of repaint()
+        DamageRect m_repaintRect;
+        /// Is repaint() running
+        bool m_repainting = false;
+        /// The textures baked for color stops of gradients
+        GradientCache m_gradientImages;
+        /// The key of the gradient being looked up, kept to reuse its memory
+        string m_gradientKey;
+        /// The scratch memory of the current frame
+        FrameArena m_arena;
+        /// The bounds of the current path
+        PathBounds m_path;
+        /// The flattened copy of the current path, nullptr if not recording
+        std::unique_ptr<Path2D> m_recordedPath;
+        /// The transform of the recorded path
+        float m_recordedTransform[6];
+        /// The bounds of the drawings with a hit id in window coordinates
+        HitGrid m_hitGrid;
+        /// The id recorded with the drawings
+        unsigned m_hitID = 0;
+        /// Are the shapes in the hit grid from a frame before the current one
+        bool m_hitsExpired = false;
+        /// The character advances of the recently used text styles, the latest first
+        std::vector<CharAdvances> m_charAdvances;
+        /// Renewed each time the position changed or baked gradient textures were evicted
+        unsigned long m_positionEpoch = nextEpoch();
+        /// Identifies the fonts of the canvas and its layers for the text metrics computed with them
+        unsigned long m_textGeneration = nextEpoch();
+        /// The current render state
+        RenderState m_state;
+        /// The render states saved by save()
+        std::vector<RenderState> m_stateStack;
+        /// The count of redundant state changes dropped in this frame
+        unsigned long m_droppedStates = 0UL;
+        /// The statistics of the current frame
+        FrameStats m_frameStats;
+        /// The depth of nested drawing calls being timed
+        unsigned m_timerDepth = 0U;
+        /// The files mapped for fonts, NanoVG reads them until the context is deleted
+        std::vector<std::shared_ptr<MappedFile>> m_mappedFiles;
     };
 }
 
@@ -26,16 +26,15 @@ namespace NanoCanvas
         };
 
 
-        Color(){ r = g = b = a = 0; }
+        constexpr Color() : r(0), g(0), b(0), a(0) {}
 
         /**
          * @brief Construct a color with an unsigned integer value
          * @param color The color code value
          */
-        Color(const unsigned int color)
-        {
-            set(color);
-        }
+        constexpr Color(const unsigned int color)
+            : r((Byte)( color >> 24U )), g((Byte)( color >> 16U )),
+              b((Byte)( color >> 8U )), a((Byte)color) {}
 
         /**
           * @brief Construct color with it's components value in the range [0,255]
@@ -44,10 +43,8 @@ namespace NanoCanvas
           * @param _b The blue component value
           * @param _a The alpha component value
          */
-        Color(Byte _r, Byte _g, Byte _b, Byte _a = 255)
-        {
-            set(_r,_g,_b,_a);
-        }
+        constexpr Color(Byte _r, Byte _g, Byte _b, Byte _a = 255)
+            : r(_r), g(_g), b(_b), a(_a) {}
         
         /**
           * @brief Construct color with it's components value in the range [0,255]
@@ -56,10 +53,8 @@ namespace NanoCanvas
           * @param _b The blue component value
           * @param _a The alpha component value
          */
-        Color(int _r, int _g, int _b, int _a = 255)
-        {
-            set(_r,_g,_b,_a);
-        }
+        constexpr Color(int _r, int _g, int _b, int _a = 255)
+            : r((Byte)_r), g((Byte)_g), b((Byte)_b), a((Byte)_a) {}
 
         /**
           * @brief Construct color with it's components value in the range [0,255]
@@ -68,10 +63,8 @@ namespace NanoCanvas
           * @param _b The blue component value
           * @param _a The alpha component value
          */
-        Color(unsigned _r, unsigned _g, unsigned _b, unsigned _a = 255)
-        {
-            set(_r,_g,_b,_a);
-        }
+        constexpr Color(unsigned _r, unsigned _g, unsigned _b, unsigned _a = 255)
+            : r((Byte)_r), g((Byte)_g), b((Byte)_b), a((Byte)_a) {}
 
          /**
           * @brief Construct color with it's components value in the range [0,1]
@@ -80,19 +73,18 @@ namespace NanoCanvas
           * @param _b The blue component value
           * @param _a The alpha component value
           */
-        Color(float _r, float _g, float _b, float _a = 1.0f)
-        {
-            set(_r,_g,_b,_a);
-        }
+        constexpr Color(float _r, float _g, float _b, float _a = 1.0f)
+            : r((Byte)(_r * UCHAR_MAX)), g((Byte)(_g * UCHAR_MAX)),
+              b((Byte)(_b * UCHAR_MAX)), a((Byte)(_a * UCHAR_MAX)) {}
 
         /// Convert the color to unsigned int as the color code
-        inline operator unsigned int() const { return code(); }
+        constexpr operator unsigned int() const { return code(); }
 
         inline Byte& operator[](int index){ return mem[index]; }
         inline const Byte operator[](int index) const { return mem[index]; }
 
-        inline bool operator==(const Color& color){  return code() == color.code(); }
-        inline bool operator<(const Color& color){ return code() < color.code(); }
+        constexpr bool operator==(const Color& color) const {  return code() == color.code(); }
+        constexpr bool operator<(const Color& color) const { return code() < color.code(); }
 
         inline Color& operator = (const unsigned int color){ return set(color); }
 
@@ -180,20 +172,15 @@ namespace NanoCanvas
             return *this;
         }
 
-        inline unsigned int code()const
+        constexpr unsigned int code()const
         {
-            unsigned int color = 0U;
-            color |= ( r   << 24U );
-            color |= ( g << 16U );
-            color |= ( b << 8U );
-            color |= a;
-            return color;
+            return ( (unsigned)r << 24U ) | ( (unsigned)g << 16U ) | ( (unsigned)b << 8U ) | a;
         }
 
-        inline float redf()const{ return   r/255.0f; }
-        inline float greenf()const{ return g/255.0f; }
-        inline float bluef()const{ return  b/255.0f; }
-        inline float alphaf()const{ return a/255.0f; }
+        constexpr float redf()const{ return   r/255.0f; }
+        constexpr float greenf()const{ return g/255.0f; }
+        constexpr float bluef()const{ return  b/255.0f; }
+        constexpr float alphaf()const{ return a/255.0f; }
         
         static Color createWidthHSL(float _h , float _s,float _l,float _a = 1.0f)
         {
@@ -205,150 +192,418 @@ namespace NanoCanvas
 
     namespace Colors
     {
-        static Color ZeroColor = 0U;
-        static Color AliceBlue = 0xF0F8FFFF;
-        static Color AntiqueWhile = 0xFAEBD7FF;
-        static Color Aqua = 0x00FFFFFF;
-        static Color Aquamarine = 0x7FFFd4FF;
-        static Color Azure = 0xF0FFFFFF;
-        static Color Beiqe = 0xF5F5DCFF;
-        static Color Bisque = 0xFFE4C4FF;
-        static Color Black = 0x000000FF;
-        static Color BlanchedAlmond = 0xFFEBCDFF;
-        static Color Blue = 0x0000FFFF;
-        static Color BlueViolet = 0x8A2BE2FF;
-        static Color Brown = 0xA52A2AFF;
-        static Color BurlyWood = 0xDEB887FF;
-        static Color CadetBlue = 0x5F9EA0FF;
-        static Color Chartreuse = 0x7FFF00FF;
-        static Color Chocolate = 0xD2691EFF;
-        static Color Coral = 0xFF7F50FF;
-        static Color CornflowerBlue= 0x6495EDFF;
-        static Color Cornsilk = 0xFFF8DCFF;
-        static Color Crimson = 0xDC143CFF;
-        static Color Cyan = 0x00FFFFFF;
-        static Color DarkBlue  = 0x00008BFF;
-        static Color DarkCyan = 0x008B8BFF;
-        static Color DarkGoldenRod = 0xB8860BFF;
-        static Color DarkGray = 0xA9A9A9FF;
-        static Color DarkGreen = 0x006400FF;
-        static Color DarkKhaki = 0xBDB76BFF;
-        static Color DarkMagenta = 0x8B008BFF;
-        static Color DarkOliveGreen = 0x556B2FFF;
-        static Color Darkorange = 0xFF8C00FF;
-        static Color DarkOrchid = 0x9932CCFF;
-        static Color DarkRed = 0x8B0000FF;
-        static Color DarkSalmon = 0xE9967AFF;
-        static Color DarkSeaGreen = 0x8FBC8FFF;
-        static Color DarkSlateBlue = 0x483D8BFF;
-        static Color DarkSlateGray = 0x2F4F4FFF;
-        static Color DarkTurquoise = 0x00CED1FF;
-        static Color DarkViolet = 0x9400D3FF;
-        static Color DeepPink = 0xFF1493FF;
-        static Color DeepSkyBlue = 0x00BFFFFF;
-        static Color DimGray = 0x696969FF;
-        static Color DodgerBlue = 0x1E90FFFF;
-        static Color Feldspar = 0xD19275FF;
-        static Color FireBrick = 0xB22222FF;
-        static Color FloralWhite = 0xFFFAF0FF;
-        static Color ForestGreen = 0x228B22FF;
-        static Color Fuchsia = 0xFF00FFFF;
-        static Color Gainsboro = 0xDCDCDCFF;
-        static Color GhostWhite = 0xF8F8FFFF;
-        static Color Gold = 0xFFD700FF;
-        static Color GoldenRod = 0xDAA520FF;
-        static Color Gray = 0x808080FF;
-        static Color Green = 0x008000FF;
-        static Color GreenYellow = 0xADFF2FFF;
-        static Color HoneyDew = 0xF0FFF0FF;
-        static Color HotPink = 0xFF69B4FF;
-        static Color IndianRed = 0xCD5C5CFF;
-        static Color Indigo = 0x4B0082FF;
-        static Color Ivory = 0xFFFFF0FF;
-        static Color Khaki = 0xF0E68CFF;
-        static Color Lavender = 0xE6E6FAFF;
-        static Color LavenderBlush = 0xFFF0F5FF;
-        static Color LawnGreen = 0x7CFC00FF;
-        static Color LemonChiffon = 0xFFFACDFF;
-        static Color LightBlue = 0xADD8E6FF;
-        static Color LightCoral = 0xF08080FF;
-        static Color LightCyan = 0xE0FFFFFF;
-        static Color LightGoldenRodYellow = 0xFAFAD2FF;
-        static Color LightGrey = 0xD3D3D3FF;
-        static Color LightGreen = 0x90EE90FF;
-        static Color LightPink = 0xFFB6C1FF;
-        static Color LightSalmon = 0xFFA07AFF;
-        static Color LightSeaGreen = 0x20B2AAFF;
-        static Color LightSkyBlue = 0x87CEFAFF;
-        static Color LightSlateBlue = 0x8470FFFF;
-        static Color LightSlateGray = 0x778899FF;
-        static Color LightSteelBlue = 0xB0C4DEFF;
-        static Color LightYellow = 0xFFFFE0FF;
-        static Color Lime = 0x00FF00FF;
-        static Color LimeGreen = 0x32CD32FF;
-        static Color Linen = 0xFAF0E6FF;
-        static Color Magenta = 0xFF00FFFF;
-        static Color Maroon = 0x800000FF;
-        static Color MediumAquaMarine = 0x66CDAAFF;
-        static Color MediumBlue = 0x0000CDFF;
-        static Color MediumOrchid = 0xBA55D3FF;
-        static Color MediumPurple = 0x9370D8FF;
-        static Color MediumSeaGreen = 0x3CB371FF;
-        static Color MediumSlateBlue = 0x7B68EEFF;
-        static Color MediumSpringGreen = 0x00FA9AFF;
-        static Color MediumTurquoise = 0x48D1CCFF;
-        static Color MediumVioletRed = 0xC71585FF;
-        static Color MidnightBlue = 0x191970FF;
-        static Color MintCream = 0xF5FFFAFF;
-        static Color MistyRose = 0xFFE4E1FF;
-        static Color Moccasin = 0xFFE4B5FF;
-        static Color NavajoWhite = 0xFFDEADFF;
-        static Color Navy = 0x000080FF;
-        static Color OldLace = 0xFDF5E6FF;
-        static Color Olive = 0x808000FF;
-        static Color OliveDrab = 0x6B8E23FF;
-        static Color Orange = 0xFFA500FF;
-        static Color OrangeRed = 0xFFA500FF;
-        static Color Orchid = 0xDA70D6FF;
-        static Color PaleGoldenRod = 0xEEE8AAFF;
-        static Color PaleGreen = 0x98FB98FF;
-        static Color PaleTurquoise = 0xAFEEEEFF;
-        static Color PaleVioletRed = 0xD87093FF;
-        static Color PapayaWhip = 0xFFEFD5FF;
-        static Color PeachPuff = 0xFFDAB9FF;
-        static Color Peru = 0xCD853FFF;
-        static Color Pink = 0xFFC0CBFF;
-        static Color Plum = 0xDDA0DDFF;
-        static Color PowderBlue = 0xB0E0E6FF;
-        static Color Purple = 0x800080FF;
-        static Color Red = 0xFF0000FF;
-        static Color RosyBrown = 0xBC8F8FFF;
-        static Color RoyalBlue = 0x4169E1FF;
-        static Color SaddleBrown = 0x8B4513FF;
-        static Color Salmon = 0xFA8072FF;
-        static Color SandyBrown = 0xF4A460FF;
-        static Color SeaGreen = 0x2E8B57FF;
-        static Color SeaShell = 0xFFF5EEFF;
-        static Color Sienna = 0xA0522DFF;
-        static Color Silver = 0xC0C0C0FF;
-        static Color SkyBlue = 0x87CEEBFF;
-        static Color SlateBlue = 0x6A5ACDFF;
-        static Color SlateGray = 0x708090FF;
-        static Color Snow = 0xFFFAFAFF;
-        static Color SpringGreen = 0x00FF7FFF;
-        static Color SteelBlue = 0x4682B4FF;
-        static Color Tan = 0xD2B48CFF;
-        static Color Teal = 0x008080FF;
-        static Color Thistle = 0xD8BFD8FF;
-        static Color Tomato = 0xFF6347FF;
-        static Color Turquoise = 0x40E0D0FF;
-        static Color Violet = 0xEE82EEFF;
-        static Color VioletRed = 0xD02090FF;
-        static Color Wheat = 0xF5DEB3FF;
-        static Color White = 0xFFFFFFFF;
-        static Color WhiteSmoke = 0xF5F5F5FF;
-        static Color Yellow = 0xFFFF00FF;
-        static Color YellowGreen = 0x9ACD32FF;
+        constexpr Color ZeroColor = 0U;
+        constexpr Color AliceBlue = 0xF0F8FFFF;
+        constexpr Color AntiqueWhile = 0xFAEBD7FF;
+        constexpr Color Aqua = 0x00FFFFFF;
+        constexpr Color Aquamarine = 0x7FFFd4FF;
+        constexpr Color Azure = 0xF0FFFFFF;
+        constexpr Color Beiqe = 0xF5F5DCFF;
+        constexpr Color Bisque = 0xFFE4C4FF;
+        constexpr Color Black = 0x000000FF;
+        constexpr Color BlanchedAlmond = 0xFFEBCDFF;
+        constexpr Color Blue = 0x0000FFFF;
+        constexpr Color BlueViolet = 0x8A2BE2FF;
+        constexpr Color Brown = 0xA52A2AFF;
+        constexpr Color BurlyWood = 0xDEB887FF;
+        constexpr Color CadetBlue = 0x5F9EA0FF;
+        constexpr Color Chartreuse = 0x7FFF00FF;
+        constexpr Color Chocolate = 0xD2691EFF;
+        constexpr Color Coral = 0xFF7F50FF;
+        constexpr Color CornflowerBlue= 0x6495EDFF;
+        constexpr Color Cornsilk = 0xFFF8DCFF;
+        constexpr Color Crimson = 0xDC143CFF;
+        constexpr Color Cyan = 0x00FFFFFF;
+        constexpr Color DarkBlue  = 0x00008BFF;
+        constexpr Color DarkCyan = 0x008B8BFF;
+        constexpr Color DarkGoldenRod = 0xB8860BFF;
+        constexpr Color DarkGray = 0xA9A9A9FF;
+        constexpr Color DarkGreen = 0x006400FF;
+        constexpr Color DarkKhaki = 0xBDB76BFF;
+        constexpr Color DarkMagenta = 0x8B008BFF;
+        constexpr Color DarkOliveGreen = 0x556B2FFF;
+        constexpr Color Darkorange = 0xFF8C00FF;
+        constexpr Color DarkOrchid = 0x9932CCFF;
+        constexpr Color DarkRed = 0x8B0000FF;
+        constexpr Color DarkSalmon = 0xE9967AFF;
+        constexpr Color DarkSeaGreen = 0x8FBC8FFF;
+        constexpr Color DarkSlateBlue = 0x483D8BFF;
+        constexpr Color DarkSlateGray = 0x2F4F4FFF;
+        constexpr Color DarkTurquoise = 0x00CED1FF;
+        constexpr Color DarkViolet = 0x9400D3FF;
+        constexpr Color DeepPink = 0xFF1493FF;
+        constexpr Color DeepSkyBlue = 0x00BFFFFF;
+        constexpr Color DimGray = 0x696969FF;
+        constexpr Color DodgerBlue = 0x1E90FFFF;
+        constexpr Color Feldspar = 0xD19275FF;
+        constexpr Color FireBrick = 0xB22222FF;
+        constexpr Color FloralWhite = 0xFFFAF0FF;
+        constexpr Color ForestGreen = 0x228B22FF;
+        constexpr Color Fuchsia = 0xFF00FFFF;
+        constexpr Color Gainsboro = 0xDCDCDCFF;
+        constexpr Color GhostWhite = 0xF8F8FFFF;
+        constexpr Color Gold = 0xFFD700FF;
+        constexpr Color GoldenRod = 0xDAA520FF;
+        constexpr Color Gray = 0x808080FF;
+        constexpr Color Green = 0x008000FF;
+        constexpr Color GreenYellow = 0xADFF2FFF;
+        constexpr Color HoneyDew = 0xF0FFF0FF;
+        constexpr Color HotPink = 0xFF69B4FF;
+        constexpr Color IndianRed = 0xCD5C5CFF;
+        constexpr Color Indigo = 0x4B0082FF;
+        constexpr Color Ivory = 0xFFFFF0FF;
+        constexpr Color Khaki = 0xF0E68CFF;
+        constexpr Color Lavender = 0xE6E6FAFF;
+        constexpr Color LavenderBlush = 0xFFF0F5FF;
+        constexpr Color LawnGreen = 0x7CFC00FF;
+        constexpr Color LemonChiffon = 0xFFFACDFF;
+        constexpr Color LightBlue = 0xADD8E6FF;
+        constexpr Color LightCoral = 0xF08080FF;
+        constexpr Color LightCyan = 0xE0FFFFFF;
+        constexpr Color LightGoldenRodYellow = 0xFAFAD2FF;
+        constexpr Color LightGrey = 0xD3D3D3FF;
+        constexpr Color LightGreen = 0x90EE90FF;
+        constexpr Color LightPink = 0xFFB6C1FF;
+        constexpr Color LightSalmon = 0xFFA07AFF;
+        constexpr Color LightSeaGreen = 0x20B2AAFF;
+        constexpr Color LightSkyBlue = 0x87CEFAFF;
+        constexpr Color LightSlateBlue = 0x8470FFFF;
+        constexpr Color LightSlateGray = 0x778899FF;
+        constexpr Color LightSteelBlue = 0xB0C4DEFF;
+        constexpr Color LightYellow = 0xFFFFE0FF;
+        constexpr Color Lime = 0x00FF00FF;
+        constexpr Color LimeGreen = 0x32CD32FF;
+        constexpr Color Linen = 0xFAF0E6FF;
+        constexpr Color Magenta = 0xFF00FFFF;
+        constexpr Color Maroon = 0x800000FF;
+        constexpr Color MediumAquaMarine = 0x66CDAAFF;
+        constexpr Color MediumBlue = 0x0000CDFF;
+        constexpr Color MediumOrchid = 0xBA55D3FF;
+        constexpr Color MediumPurple = 0x9370DBFF;
+        constexpr Color MediumSeaGreen = 0x3CB371FF;
+        constexpr Color MediumSlateBlue = 0x7B68EEFF;
+        constexpr Color MediumSpringGreen = 0x00FA9AFF;
+        constexpr Color MediumTurquoise = 0x48D1CCFF;
+        constexpr Color MediumVioletRed = 0xC71585FF;
+        constexpr Color MidnightBlue = 0x191970FF;
+        constexpr Color MintCream = 0xF5FFFAFF;
+        constexpr Color MistyRose = 0xFFE4E1FF;
+        constexpr Color Moccasin = 0xFFE4B5FF;
+        constexpr Color NavajoWhite = 0xFFDEADFF;
+        constexpr Color Navy = 0x000080FF;
+        constexpr Color OldLace = 0xFDF5E6FF;
+        constexpr Color Olive = 0x808000FF;
+        constexpr Color OliveDrab = 0x6B8E23FF;
+        constexpr Color Orange = 0xFFA500FF;
+        constexpr Color OrangeRed = 0xFF4500FF;
+        constexpr Color Orchid = 0xDA70D6FF;
+        constexpr Color PaleGoldenRod = 0xEEE8AAFF;
+        constexpr Color PaleGreen = 0x98FB98FF;
+        constexpr Color PaleTurquoise = 0xAFEEEEFF;
+        constexpr Color PaleVioletRed = 0xDB7093FF;
+        constexpr Color PapayaWhip = 0xFFEFD5FF;
+        constexpr Color PeachPuff = 0xFFDAB9FF;
+        constexpr Color Peru = 0xCD853FFF;
+        constexpr Color Pink = 0xFFC0CBFF;
+        constexpr Color Plum = 0xDDA0DDFF;
+        constexpr Color PowderBlue = 0xB0E0E6FF;
+        constexpr Color Purple = 0x800080FF;
+        constexpr Color RebeccaPurple = 0x663399FF;
+        constexpr Color Red = 0xFF0000FF;
+        constexpr Color RosyBrown = 0xBC8F8FFF;
+        constexpr Color RoyalBlue = 0x4169E1FF;
+        constexpr Color SaddleBrown = 0x8B4513FF;
+        constexpr Color Salmon = 0xFA8072FF;
+        constexpr Color SandyBrown = 0xF4A460FF;
+        constexpr Color SeaGreen = 0x2E8B57FF;
+        constexpr Color SeaShell = 0xFFF5EEFF;
+        constexpr Color Sienna = 0xA0522DFF;
+        constexpr Color Silver = 0xC0C0C0FF;
+        constexpr Color SkyBlue = 0x87CEEBFF;
+        constexpr Color SlateBlue = 0x6A5ACDFF;
+        constexpr Color SlateGray = 0x708090FF;
+        constexpr Color Snow = 0xFFFAFAFF;
+        constexpr Color SpringGreen = 0x00FF7FFF;
+        constexpr Color SteelBlue = 0x4682B4FF;
+        constexpr Color Tan = 0xD2B48CFF;
+        constexpr Color Teal = 0x008080FF;
+        constexpr Color Thistle = 0xD8BFD8FF;
+        constexpr Color Tomato = 0xFF6347FF;
+        constexpr Color Turquoise = 0x40E0D0FF;
+        constexpr Color Violet = 0xEE82EEFF;
+        constexpr Color VioletRed = 0xD02090FF;
+        constexpr Color Wheat = 0xF5DEB3FF;
+        constexpr Color White = 0xFFFFFFFF;
+        constexpr Color WhiteSmoke = 0xF5F5F5FF;
+        constexpr Color Yellow = 0xFFFF00FF;
+        constexpr Color YellowGreen = 0x9ACD32FF;
+    }
+
+    /// A color with its CSS name
+    struct NamedColor
+    {
+        const char * name;
+        unsigned int code;
+    };
+    
+    /// The CSS color names in lower case
+    constexpr NamedColor ColorNames[] =
+    {
+        { "aliceblue",            Colors::AliceBlue.code() },
+        { "antiquewhite",         Colors::AntiqueWhile.code() },
+        { "aqua",                 Colors::Aqua.code() },
+        { "aquamarine",           Colors::Aquamarine.code() },
+        { "azure",                Colors::Azure.code() },
+        { "beige",                Colors::Beiqe.code() },
+        { "bisque",               Colors::Bisque.code() },
+        { "black",                Colors::Black.code() },
+        { "blanchedalmond",       Colors::BlanchedAlmond.code() },
+        { "blue",                 Colors::Blue.code() },
+        { "blueviolet",           Colors::BlueViolet.code() },
+        { "brown",                Colors::Brown.code() },
+        { "burlywood",            Colors::BurlyWood.code() },
+        { "cadetblue",            Colors::CadetBlue.code() },
+        { "chartreuse",           Colors::Chartreuse.code() },
+        { "chocolate",            Colors::Chocolate.code() },
+        { "coral",                Colors::Coral.code() },
+        { "cornflowerblue",       Colors::CornflowerBlue.code() },
+        { "cornsilk",             Colors::Cornsilk.code() },
+        { "crimson",              Colors::Crimson.code() },
+        { "cyan",                 Colors::Cyan.code() },
+        { "darkblue",             Colors::DarkBlue.code() },
+        { "darkcyan",             Colors::DarkCyan.code() },
+        { "darkgoldenrod",        Colors::DarkGoldenRod.code() },
+        { "darkgray",             Colors::DarkGray.code() },
+        { "darkgrey",             Colors::DarkGray.code() },
+        { "darkgreen",            Colors::DarkGreen.code() },
+        { "darkkhaki",            Colors::DarkKhaki.code() },
+        { "darkmagenta",          Colors::DarkMagenta.code() },
+        { "darkolivegreen",       Colors::DarkOliveGreen.code() },
+        { "darkorange",           Colors::Darkorange.code() },
+        { "darkorchid",           Colors::DarkOrchid.code() },
+        { "darkred",              Colors::DarkRed.code() },
+        { "darksalmon",           Colors::DarkSalmon.code() },
+        { "darkseagreen",         Colors::DarkSeaGreen.code() },
+        { "darkslateblue",        Colors::DarkSlateBlue.code() },
+        { "darkslategray",        Colors::DarkSlateGray.code() },
+        { "darkslategrey",        Colors::DarkSlateGray.code() },
+        { "darkturquoise",        Colors::DarkTurquoise.code() },
+        { "darkviolet",           Colors::DarkViolet.code() },
+        { "deeppink",             Colors::DeepPink.code() },
+        { "deepskyblue",          Colors::DeepSkyBlue.code() },
+        { "dimgray",              Colors::DimGray.code() },
+        { "dimgrey",              Colors::DimGray.code() },
+        { "dodgerblue",           Colors::DodgerBlue.code() },
+        { "firebrick",            Colors::FireBrick.code() },
+        { "floralwhite",          Colors::FloralWhite.code() },
+        { "forestgreen",          Colors::ForestGreen.code() },
+        { "fuchsia",              Colors::Fuchsia.code() },
+        { "gainsboro",            Colors::Gainsboro.code() },
+        { "ghostwhite",           Colors::GhostWhite.code() },
+        { "gold",                 Colors::Gold.code() },
+        { "goldenrod",            Colors::GoldenRod.code() },
+        { "gray",                 Colors::Gray.code() },
+        { "grey",                 Colors::Gray.code() },
+        { "green",                Colors::Green.code() },
+        { "greenyellow",          Colors::GreenYellow.code() },
+        { "honeydew",             Colors::HoneyDew.code() },
+        { "hotpink",              Colors::HotPink.code() },
+        { "indianred",            Colors::IndianRed.code() },
+        { "indigo",               Colors::Indigo.code() },
+        { "ivory",                Colors::Ivory.code() },
+        { "khaki",                Colors::Khaki.code() },
+        { "lavender",             Colors::Lavender.code() },
+        { "lavenderblush",        Colors::LavenderBlush.code() },
+        { "lawngreen",            Colors::LawnGreen.code() },
+        { "lemonchiffon",         Colors::LemonChiffon.code() },
+        { "lightblue",            Colors::LightBlue.code() },
+        { "lightcoral",           Colors::LightCoral.code() },
+        { "lightcyan",            Colors::LightCyan.code() },
+        { "lightgoldenrodyellow", Colors::LightGoldenRodYellow.code() },
+        { "lightgrey",            Colors::LightGrey.code() },
+        { "lightgray",            Colors::LightGrey.code() },
+        { "lightgreen",           Colors::LightGreen.code() },
+        { "lightpink",            Colors::LightPink.code() },
+        { "lightsalmon",          Colors::LightSalmon.code() },
+        { "lightseagreen",        Colors::LightSeaGreen.code() },
+        { "lightskyblue",         Colors::LightSkyBlue.code() },
+        { "lightslategray",       Colors::LightSlateGray.code() },
+        { "lightslategrey",       Colors::LightSlateGray.code() },
+        { "lightsteelblue",       Colors::LightSteelBlue.code() },
+        { "lightyellow",          Colors::LightYellow.code() },
+        { "lime",                 Colors::Lime.code() },
+        { "limegreen",            Colors::LimeGreen.code() },
+        { "linen",                Colors::Linen.code() },
+        { "magenta",              Colors::Magenta.code() },
+        { "maroon",               Colors::Maroon.code() },
+        { "mediumaquamarine",     Colors::MediumAquaMarine.code() },
+        { "mediumblue",           Colors::MediumBlue.code() },
+        { "mediumorchid",         Colors::MediumOrchid.code() },
+        { "mediumpurple",         Colors::MediumPurple.code() },
+        { "mediumseagreen",       Colors::MediumSeaGreen.code() },
+        { "mediumslateblue",      Colors::MediumSlateBlue.code() },
+        { "mediumspringgreen",    Colors::MediumSpringGreen.code() },
+        { "mediumturquoise",      Colors::MediumTurquoise.code() },
+        { "mediumvioletred",      Colors::MediumVioletRed.code() },
+        { "midnightblue",         Colors::MidnightBlue.code() },
+        { "mintcream",            Colors::MintCream.code() },
+        { "mistyrose",            Colors::MistyRose.code() },
+        { "moccasin",             Colors::Moccasin.code() },
+        { "navajowhite",          Colors::NavajoWhite.code() },
+        { "navy",                 Colors::Navy.code() },
+        { "oldlace",              Colors::OldLace.code() },
+        { "olive",                Colors::Olive.code() },
+        { "olivedrab",            Colors::OliveDrab.code() },
+        { "orange",               Colors::Orange.code() },
+        { "orangered",            Colors::OrangeRed.code() },
+        { "orchid",               Colors::Orchid.code() },
+        { "palegoldenrod",        Colors::PaleGoldenRod.code() },
+        { "palegreen",            Colors::PaleGreen.code() },
+        { "paleturquoise",        Colors::PaleTurquoise.code() },
+        { "palevioletred",        Colors::PaleVioletRed.code() },
+        { "papayawhip",           Colors::PapayaWhip.code() },
+        { "peachpuff",            Colors::PeachPuff.code() },
+        { "peru",                 Colors::Peru.code() },
+        { "pink",                 Colors::Pink.code() },
+        { "plum",                 Colors::Plum.code() },
+        { "powderblue",           Colors::PowderBlue.code() },
+        { "purple",               Colors::Purple.code() },
+        { "rebeccapurple",        Colors::RebeccaPurple.code() },
+        { "red",                  Colors::Red.code() },
+        { "rosybrown",            Colors::RosyBrown.code() },
+        { "royalblue",            Colors::RoyalBlue.code() },
+        { "saddlebrown",          Colors::SaddleBrown.code() },
+        { "salmon",               Colors::Salmon.code() },
+        { "sandybrown",           Colors::SandyBrown.code() },
+        { "seagreen",             Colors::SeaGreen.code() },
+        { "seashell",             Colors::SeaShell.code() },
+        { "sienna",               Colors::Sienna.code() },
+        { "silver",               Colors::Silver.code() },
+        { "skyblue",              Colors::SkyBlue.code() },
+        { "slateblue",            Colors::SlateBlue.code() },
+        { "slategray",            Colors::SlateGray.code() },
+        { "slategrey",            Colors::SlateGray.code() },
+        { "snow",                 Colors::Snow.code() },
+        { "springgreen",          Colors::SpringGreen.code() },
+        { "steelblue",            Colors::SteelBlue.code() },
+        { "tan",                  Colors::Tan.code() },
+        { "teal",                 Colors::Teal.code() },
+        { "thistle",              Colors::Thistle.code() },
+        { "tomato",               Colors::Tomato.code() },
+        { "turquoise",            Colors::Turquoise.code() },
+        { "violet",               Colors::Violet.code() },
+        { "wheat",                Colors::Wheat.code() },
+        { "white",                Colors::White.code() },
+        { "whitesmoke",           Colors::WhiteSmoke.code() },
+        { "yellow",               Colors::Yellow.code() },
+        { "yellowgreen",          Colors::YellowGreen.code() },
+        { "transparent",          Colors::ZeroColor.code() }
+    };
+    
+    /// Compile-time helpers of parseColor(), the results are color codes or -1 for invalid text
+    namespace ColorParser
+    {
+        constexpr size_t length(const char* text)
+        {
+            return *text ? 1 + length(text + 1) : 0;
+        }
+        
+        constexpr char lower(char c)
+        {
+            return c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c;
+        }
+        
+        constexpr int hexDigit(char c)
+        {
+            return c >= '0' && c <= '9' ? c - '0' :
+                   c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+                   c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+        }
+        
+        constexpr long long hexValue(const char* text,size_t count,long long value)
+        {
+            return count == 0 ? value :
+                   hexDigit(*text) < 0 ? -1 : hexValue(text + 1,count - 1,value*16 + hexDigit(*text));
+        }
+        
+        constexpr long long opaque(long long rgb)
+        {
+            return rgb < 0 ? -1 : ( rgb << 8 ) | 0xFF;
+        }
+        
+        constexpr bool sameName(const char* text,size_t length,const char* name)
+        {
+            return length == 0 ? *name == 0 :
+                   *name != 0 && lower(*text) == *name && sameName(text + 1,length - 1,name + 1);
+        }
+        
+        constexpr long long findName(const char* text,size_t length,size_t index)
+        {
+            return index == sizeof(ColorNames)/sizeof(ColorNames[0]) ? -1 :
+                   sameName(text,length,ColorNames[index].name) ? ColorNames[index].code :
+                   findName(text,length,index + 1);
+        }
+        
+        constexpr long long parse(const char* text,size_t length)
+        {
+            return length > 0 && text[0] == '#' ?
+                   ( length == 7 ? opaque(hexValue(text + 1,6,0)) :
+                     length == 9 ? hexValue(text + 1,8,0) : -1 ) :
+                   findName(text,length,0);
+        }
+        
+        constexpr Color color(long long code)
+        {
+            return code < 0 ? Colors::ZeroColor : Color((unsigned int)code);
+        }
+        
+        /// Not constexpr on purpose, an invalid literal in a constant expression fails to compile here
+        inline Color invalidColorLiteral()
+        {
+            return Colors::ZeroColor;
+        }
+        
+        constexpr Color literal(long long code)
+        {
+            return code < 0 ? invalidColorLiteral() : Color((unsigned int)code);
+        }
+    }
+    
+    /**
+     * @brief Parse a color from @b "#RRGGBB", @b "#RRGGBBAA" or a CSS color name
+     * 
+     * It can be evaluated at compile time, the names are case-insensitive.
+     * @param text The text to parse
+     * @param length The length of the text
+     * @return The parsed color, Colors::ZeroColor if the text is not a color
+     */
+    constexpr Color parseColor(const char* text,size_t length)
+    {
+        return ColorParser::color(ColorParser::parse(text,length));
+    }
+    
+    /**
+     * @brief Parse a color from a null-terminated text
+     * @see parseColor(const char*,size_t)
+     */
+    constexpr Color parseColor(const char* text)
+    {
+        return parseColor(text,ColorParser::length(text));
+    }
+    
+    /**
+     * @brief The color literal parsed at compile time
+     * @code
+     * constexpr Color accent = "#FF8800"_color;
+     * canvas.fillStyle("steelblue"_color);
+     * @endcode
+     * @attention A text which is not a color fails to compile in constant expressions,
+     * like constexpr variables. Elsewhere it is Colors::ZeroColor, as with parseColor.
+     * @see parseColor
+     */
+    constexpr Color operator"" _color(const char* text,size_t length)
+    {
+        return ColorParser::literal(ColorParser::parse(text,length));
     }
 
     /** @brief Get hex code string from color */
@@ -0,0 +1,294 @@
+// The SIMD and the scalar code must round alike, the compiler may not fuse or reorder their float math
+#if defined(__clang__)
+    #pragma STDC FP_CONTRACT OFF
+    #pragma float_control(precise,on)
+#elif defined(__GNUC__)
+    #pragma GCC optimize("fp-contract=off","no-fast-math")
+#elif defined(_MSC_VER)
+    #pragma fp_contract(off)
+    #pragma float_control(precise,on)
+#endif
+#include "NanoCanvas.h"
+#include "nanovg.h"
+#if !defined(NANOCANVAS_NO_SIMD) && ( defined(__SSE2__) || defined(_M_X64) || \
+    ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 ) )
+    #define NANOCANVAS_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace NanoCanvas
+{
+namespace ColorConverter
+{
+    // The scalar code does the same float operations in the same order as the SIMD code,
+    // min and max are written to behave like minps and maxps, so both give the same bytes.
+
+    static inline float minf(float a,float b){ return a < b ? a : b; }
+    static inline float maxf(float a,float b){ return a > b ? a : b; }
+
+    static inline float floorScalar(float x)
+    {
+        float t = (float)(int)x;
+        return t > x ? t - 1.0f : t;
+    }
+
+    static inline byte toByte(float x)
+    {
+        return (byte)(int)( minf(maxf(x,0.0f),1.0f) * 255.0f );
+    }
+
+    static inline float hslChannel(float n,float h12,float l,float a)
+    {
+        float k = n + h12;
+        k = k >= 12.0f ? k - 12.0f : k;
+        float m = maxf(minf(minf(k - 3.0f,9.0f - k),1.0f),-1.0f);
+        return l - a*m;
+    }
+
+    static inline float hsvChannel(float n,float h6,float v,float vs)
+    {
+        float k = n + h6;
+        k = k >= 6.0f ? k - 6.0f : k;
+        float m = maxf(minf(minf(k,4.0f - k),1.0f),0.0f);
+        return v - vs*m;
+    }
+
+    static inline void hslToRgba(float h,float s,float l,float a,byte* rgba)
+    {
+        s = minf(maxf(s,0.0f),1.0f);
+        l = minf(maxf(l,0.0f),1.0f);
+        float h12 = (h - floorScalar(h))*12.0f;
+        float chroma = s*minf(l,1.0f - l);
+        rgba[0] = toByte(hslChannel(0.0f,h12,l,chroma));
+        rgba[1] = toByte(hslChannel(8.0f,h12,l,chroma));
+        rgba[2] = toByte(hslChannel(4.0f,h12,l,chroma));
+        rgba[3] = toByte(a);
+    }
+
+    static inline void hsvToRgba(float h,float s,float v,float a,byte* rgba)
+    {
+        s = minf(maxf(s,0.0f),1.0f);
+        v = minf(maxf(v,0.0f),1.0f);
+        float h6 = (h - floorScalar(h))*6.0f;
+        float vs = v*s;
+        rgba[0] = toByte(hsvChannel(5.0f,h6,v,vs));
+        rgba[1] = toByte(hsvChannel(3.0f,h6,v,vs));
+        rgba[2] = toByte(hsvChannel(1.0f,h6,v,vs));
+        rgba[3] = toByte(a);
+    }
+
+    /// The hue of a color in [0, 1], 0 for grays
+    static inline float hue(float r,float g,float b,float max,float d)
+    {
+        float safe = d == 0.0f ? 1.0f : d;
+        float hr = (g - b)/safe;
+        hr = hr < 0.0f ? hr + 6.0f : hr;
+        float hg = (b - r)/safe + 2.0f;
+        float hb = (r - g)/safe + 4.0f;
+        float h = max == r ? hr : ( max == g ? hg : hb );
+        return d == 0.0f ? 0.0f : h/6.0f;
+    }
+
+    static inline void rgbaToHsl(const byte* rgba,float& h,float& s,float& l)
+    {
+        float r = rgba[0]/255.0f;
+        float g = rgba[1]/255.0f;
+        float b = rgba[2]/255.0f;
+        float max = maxf(maxf(r,g),b);
+        float min = minf(minf(r,g),b);
+        float d = max - min;
+        l = (max + min)*0.5f;
+        float denom = l > 0.5f ? (2.0f - max) - min : max + min;
+        denom = d == 0.0f ? 1.0f : denom;
+        s = d == 0.0f ? 0.0f : d/denom;
+        h = hue(r,g,b,max,d);
+    }
+
+    static inline void rgbaToHsv(const byte* rgba,float& h,float& s,float& v)
+    {
+        float r = rgba[0]/255.0f;
+        float g = rgba[1]/255.0f;
+        float b = rgba[2]/255.0f;
+        float max = maxf(maxf(r,g),b);
+        float min = minf(minf(r,g),b);
+        float d = max - min;
+        v = max;
+        s = d == 0.0f ? 0.0f : d/( d == 0.0f ? 1.0f : max );
+        h = hue(r,g,b,max,d);
+    }
+
+#ifdef NANOCANVAS_SSE2
+    static inline __m128 select4(__m128 mask,__m128 a,__m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask,a),_mm_andnot_ps(mask,b));
+    }
+
+    static inline __m128 clamp4(__m128 x,__m128 a,__m128 b)
+    {
+        return _mm_min_ps(_mm_max_ps(x,a),b);
+    }
+
+    static inline __m128 floor4(__m128 x)
+    {
+        __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        return _mm_sub_ps(t,_mm_and_ps(_mm_cmpgt_ps(t,x),_mm_set1_ps(1.0f)));
+    }
+
+    static inline __m128i toByte4(__m128 x)
+    {
+        return _mm_cvttps_epi32(_mm_mul_ps(clamp4(x,_mm_setzero_ps(),_mm_set1_ps(1.0f)),
+                                           _mm_set1_ps(255.0f)));
+    }
+
+    /// Pack 4 colors from their channels in 32-bit lanes
+    static inline void store4(__m128 r,__m128 g,__m128 b,__m128 a,byte* rgba)
+    {
+        __m128i color = _mm_or_si128(_mm_or_si128(toByte4(r),_mm_slli_epi32(toByte4(g),8)),
+                                     _mm_or_si128(_mm_slli_epi32(toByte4(b),16),
+                                                  _mm_slli_epi32(toByte4(a),24)));
+        _mm_storeu_si128((__m128i*)rgba,color);
+    }
+
+    /// Unpack 4 colors to their channels in [0, 1]
+    static inline void load4(const byte* rgba,__m128& r,__m128& g,__m128& b)
+    {
+        __m128i color = _mm_loadu_si128((const __m128i*)rgba);
+        __m128i mask = _mm_set1_epi32(0xFF);
+        __m128 scale = _mm_set1_ps(255.0f);
+        r = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(color,mask)),scale);
+        g = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(color,8),mask)),scale);
+        b = _mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(color,16),mask)),scale);
+    }
+
+    static inline __m128 hslChannel4(float n,__m128 h12,__m128 l,__m128 a)
+    {
+        __m128 twelve = _mm_set1_ps(12.0f);
+        __m128 k = _mm_add_ps(_mm_set1_ps(n),h12);
+        k = _mm_sub_ps(k,_mm_and_ps(_mm_cmpge_ps(k,twelve),twelve));
+        __m128 m = _mm_min_ps(_mm_sub_ps(k,_mm_set1_ps(3.0f)),_mm_sub_ps(_mm_set1_ps(9.0f),k));
+        m = _mm_max_ps(_mm_min_ps(m,_mm_set1_ps(1.0f)),_mm_set1_ps(-1.0f));
+        return _mm_sub_ps(l,_mm_mul_ps(a,m));
+    }
+
+    static inline __m128 hsvChannel4(float n,__m128 h6,__m128 v,__m128 vs)
+    {
+        __m128 six = _mm_set1_ps(6.0f);
+        __m128 k = _mm_add_ps(_mm_set1_ps(n),h6);
+        k = _mm_sub_ps(k,_mm_and_ps(_mm_cmpge_ps(k,six),six));
+        __m128 m = _mm_min_ps(k,_mm_sub_ps(_mm_set1_ps(4.0f),k));
+        m = _mm_max_ps(_mm_min_ps(m,_mm_set1_ps(1.0f)),_mm_setzero_ps());
+        return _mm_sub_ps(v,_mm_mul_ps(vs,m));
+    }
+
+    static inline __m128 hue4(__m128 r,__m128 g,__m128 b,__m128 max,__m128 d)
+    {
+        __m128 zero = _mm_setzero_ps();
+        __m128 gray = _mm_cmpeq_ps(d,zero);
+        __m128 safe = select4(gray,_mm_set1_ps(1.0f),d);
+        __m128 hr = _mm_div_ps(_mm_sub_ps(g,b),safe);
+        hr = select4(_mm_cmplt_ps(hr,zero),_mm_add_ps(hr,_mm_set1_ps(6.0f)),hr);
+        __m128 hg = _mm_add_ps(_mm_div_ps(_mm_sub_ps(b,r),safe),_mm_set1_ps(2.0f));
+        __m128 hb = _mm_add_ps(_mm_div_ps(_mm_sub_ps(r,g),safe),_mm_set1_ps(4.0f));
+        __m128 h = select4(_mm_cmpeq_ps(max,r),hr,select4(_mm_cmpeq_ps(max,g),hg,hb));
+        return select4(gray,zero,_mm_div_ps(h,_mm_set1_ps(6.0f)));
+    }
+#endif
+
+    void hslToRgba(const float* h,const float* s,const float* l,const float* a,
+                   size_t count,byte* rgba)
+    {
+        size_t i = 0;
+#ifdef NANOCANVAS_SSE2
+        __m128 zero = _mm_setzero_ps();
+        __m128 one = _mm_set1_ps(1.0f);
+        for( ; i + 4 <= count ; i += 4 , rgba += 16 )
+        {
+            __m128 hh = _mm_loadu_ps(h + i);
+            __m128 ss = clamp4(_mm_loadu_ps(s + i),zero,one);
+            __m128 ll = clamp4(_mm_loadu_ps(l + i),zero,one);
+            __m128 aa = a ? _mm_loadu_ps(a + i) : one;
+            __m128 h12 = _mm_mul_ps(_mm_sub_ps(hh,floor4(hh)),_mm_set1_ps(12.0f));
+            __m128 chroma = _mm_mul_ps(ss,_mm_min_ps(ll,_mm_sub_ps(one,ll)));
+            store4(hslChannel4(0.0f,h12,ll,chroma),hslChannel4(8.0f,h12,ll,chroma),
+                   hslChannel4(4.0f,h12,ll,chroma),aa,rgba);
+        }
+#endif
+        for( ; i < count ; ++i , rgba += 4 )
+            hslToRgba(h[i],s[i],l[i],a ? a[i] : 1.0f,rgba);
+    }
+
+    void hsvToRgba(const float* h,const float* s,const float* v,const float* a,
+                   size_t count,byte* rgba)
+    {
+        size_t i = 0;
+#ifdef NANOCANVAS_SSE2
+        __m128 zero = _mm_setzero_ps();
+        __m128 one = _mm_set1_ps(1.0f);
+        for( ; i + 4 <= count ; i += 4 , rgba += 16 )
+        {
+            __m128 hh = _mm_loadu_ps(h + i);
+            __m128 ss = clamp4(_mm_loadu_ps(s + i),zero,one);
+            __m128 vv = clamp4(_mm_loadu_ps(v + i),zero,one);
+            __m128 aa = a ? _mm_loadu_ps(a + i) : one;
+            __m128 h6 = _mm_mul_ps(_mm_sub_ps(hh,floor4(hh)),_mm_set1_ps(6.0f));
+            __m128 vs = _mm_mul_ps(vv,ss);
+            store4(hsvChannel4(5.0f,h6,vv,vs),hsvChannel4(3.0f,h6,vv,vs),
+                   hsvChannel4(1.0f,h6,vv,vs),aa,rgba);
+        }
+#endif
+        for( ; i < count ; ++i , rgba += 4 )
+            hsvToRgba(h[i],s[i],v[i],a ? a[i] : 1.0f,rgba);
+    }
+
+    void rgbaToHsl(const byte* rgba,size_t count,float* h,float* s,float* l)
+    {
+        size_t i = 0;
+#ifdef NANOCANVAS_SSE2
+        __m128 zero = _mm_setzero_ps();
+        __m128 one = _mm_set1_ps(1.0f);
+        for( ; i + 4 <= count ; i += 4 , rgba += 16 )
+        {
+            __m128 r,g,b;
+            load4(rgba,r,g,b);
+            __m128 max = _mm_max_ps(_mm_max_ps(r,g),b);
+            __m128 min = _mm_min_ps(_mm_min_ps(r,g),b);
+            __m128 d = _mm_sub_ps(max,min);
+            __m128 gray = _mm_cmpeq_ps(d,zero);
+            __m128 ll = _mm_mul_ps(_mm_add_ps(max,min),_mm_set1_ps(0.5f));
+            __m128 denom = select4(_mm_cmpgt_ps(ll,_mm_set1_ps(0.5f)),
+                                   _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(2.0f),max),min),
+                                   _mm_add_ps(max,min));
+            denom = select4(gray,one,denom);
+            _mm_storeu_ps(h + i,hue4(r,g,b,max,d));
+            _mm_storeu_ps(s + i,select4(gray,zero,_mm_div_ps(d,denom)));
+            _mm_storeu_ps(l + i,ll);
+        }
+#endif
+        for( ; i < count ; ++i , rgba += 4 )
+            rgbaToHsl(rgba,h[i],s[i],l[i]);
+    }
+
+    void rgbaToHsv(const byte* rgba,size_t count,float* h,float* s,float* v)
+    {
+        size_t i = 0;
+#ifdef NANOCANVAS_SSE2
+        __m128 zero = _mm_setzero_ps();
+        __m128 one = _mm_set1_ps(1.0f);
+        for( ; i + 4 <= count ; i += 4 , rgba += 16 )
+        {
+            __m128 r,g,b;
+            load4(rgba,r,g,b);
+            __m128 max = _mm_max_ps(_mm_max_ps(r,g),b);
+            __m128 min = _mm_min_ps(_mm_min_ps(r,g),b);
+            __m128 d = _mm_sub_ps(max,min);
+            __m128 gray = _mm_cmpeq_ps(d,zero);
+            _mm_storeu_ps(h + i,hue4(r,g,b,max,d));
+            _mm_storeu_ps(s + i,select4(gray,zero,_mm_div_ps(d,select4(gray,one,max))));
+            _mm_storeu_ps(v + i,max);
+        }
+#endif
+        for( ; i < count ; ++i , rgba += 4 )
+            rgbaToHsv(rgba,h[i],s[i],v[i]);
+    }
+}
+}
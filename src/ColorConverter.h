@@ -79,7 +79,25 @@ namespace ColorConverter
      */
      static void rgbToHsl(byte r, byte g, byte b, double hsl[])
      {
-         // TODO:
+         double rd = r / 255.0, gd = g / 255.0, bd = b / 255.0;
+         double max = threeway_max(rd, gd, bd);
+         double min = threeway_min(rd, gd, bd);
+         double d = max - min;
+         double h = 0.0, s = 0.0, l = (max + min) / 2.0;
+         if (d > 0.0)
+         {
+             s = l > 0.5 ? d / (2.0 - max - min) : d / (max + min);
+             if (max == rd)
+                 h = (gd - bd) / d + (gd < bd ? 6.0 : 0.0);
+             else if (max == gd)
+                 h = (bd - rd) / d + 2.0;
+             else
+                 h = (rd - gd) / d + 4.0;
+             h /= 6.0;
+         }
+         hsl[0] = h;
+         hsl[1] = s;
+         hsl[2] = l;
      }
      
 
@@ -96,7 +114,24 @@ namespace ColorConverter
      */
     static void rgbToHsv(byte r, byte g, byte b, double hsv[])
     {
-        // TODO:
+        double rd = r / 255.0, gd = g / 255.0, bd = b / 255.0;
+        double max = threeway_max(rd, gd, bd);
+        double min = threeway_min(rd, gd, bd);
+        double d = max - min;
+        double h = 0.0, s = max > 0.0 ? d / max : 0.0;
+        if (d > 0.0)
+        {
+            if (max == rd)
+                h = (gd - bd) / d + (gd < bd ? 6.0 : 0.0);
+            else if (max == gd)
+                h = (bd - rd) / d + 2.0;
+            else
+                h = (rd - gd) / d + 4.0;
+            h /= 6.0;
+        }
+        hsv[0] = h;
+        hsv[1] = s;
+        hsv[2] = max;
     }
     
    /**
@@ -112,8 +147,94 @@ namespace ColorConverter
      */
     static void hsvToRgb(double h, double s, double v, byte rgb[])
     {
-        // TODO:
+        double useless;
+        h = std::modf(h,&useless);
+        if (h < 0.0) h += 1.0;
+        s = clamp(s,0.0,1.0);
+        v = clamp(v,0.0,1.0);
+        
+        int i = int(h * 6.0);
+        double f = h * 6.0 - i;
+        double p = v * (1.0 - s);
+        double q = v * (1.0 - f * s);
+        double t = v * (1.0 - (1.0 - f) * s);
+        double r, g, b;
+        switch (i % 6)
+        {
+            case 0: r = v; g = t; b = p; break;
+            case 1: r = q; g = v; b = p; break;
+            case 2: r = p; g = v; b = t; break;
+            case 3: r = p; g = q; b = v; break;
+            case 4: r = t; g = p; b = v; break;
+            default: r = v; g = p; b = q; break;
+        }
+        
+        rgb[0] = byte(r*255);
+        rgb[1] = byte(g*255);
+        rgb[2] = byte(b*255);
     }
+    
+    /*
+     * Batch conversions between float channel arrays and packed colors.
+     * Packed colors are 4 bytes each in the memory order of Color (r, g, b, a),
+     * so an array of Color can be passed as (byte*)colors.
+     * The conversions use SSE2 when it is available and float scalar code
+     * computing the same results otherwise, batches of less than four colors
+     * always run the scalar code. Results may differ from the
+     * double precision functions above by one in the last bit of a byte.
+     */
+    
+    /**
+     * Converts arrays of HSL values to packed RGBA colors.
+     * Hues wrap around [0, 1], the other values are clamped to [0, 1].
+     *
+     * @param   float   h[]     The hues
+     * @param   float   s[]     The saturations
+     * @param   float   l[]     The lightnesses
+     * @param   float   a[]     The alphas, or nullptr for opaque colors
+     * @param   size_t  count   The count of colors
+     * @return  byte    rgba[]  The 4 * count bytes of packed colors
+     */
+    void hslToRgba(const float* h, const float* s, const float* l, const float* a,
+                   size_t count, byte* rgba);
+    
+    /**
+     * Converts arrays of HSV values to packed RGBA colors.
+     * Hues wrap around [0, 1], the other values are clamped to [0, 1].
+     *
+     * @param   float   h[]     The hues
+     * @param   float   s[]     The saturations
+     * @param   float   v[]     The values
+     * @param   float   a[]     The alphas, or nullptr for opaque colors
+     * @param   size_t  count   The count of colors
+     * @return  byte    rgba[]  The 4 * count bytes of packed colors
+     */
+    void hsvToRgba(const float* h, const float* s, const float* v, const float* a,
+                   size_t count, byte* rgba);
+    
+    /**
+     * Converts packed RGBA colors to arrays of HSL values in [0, 1].
+     * The alphas are ignored.
+     *
+     * @param   byte    rgba[]  The 4 * count bytes of packed colors
+     * @param   size_t  count   The count of colors
+     * @return  float   h[]     The hues
+     * @return  float   s[]     The saturations
+     * @return  float   l[]     The lightnesses
+     */
+    void rgbaToHsl(const byte* rgba, size_t count, float* h, float* s, float* l);
+    
+    /**
+     * Converts packed RGBA colors to arrays of HSV values in [0, 1].
+     * The alphas are ignored.
+     *
+     * @param   byte    rgba[]  The 4 * count bytes of packed colors
+     * @param   size_t  count   The count of colors
+     * @return  float   h[]     The hues
+     * @return  float   s[]     The saturations
+     * @return  float   v[]     The values
+     */
+    void rgbaToHsv(const byte* rgba, size_t count, float* h, float* s, float* v);
 };
 
 #endif //ColorConverter_H_
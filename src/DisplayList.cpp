@@ -0,0 +1,342 @@
+#include "NanoCanvas.h"
+#include "nanovg.h"
+
+namespace NanoCanvas
+{
+    DisplayList& DisplayList::push(Op op,std::initializer_list<float> args,unsigned ref)
+    {
+        Command cmd;
+        cmd.op = op;
+        cmd.args = (unsigned)m_args.size();
+        cmd.ref = ref;
+        m_args.insert(m_args.end(),args.begin(),args.end());
+        m_commands.push_back(cmd);
+        return *this;
+    }
+
+    void DisplayList::clear()
+    {
+        m_commands.clear();
+        m_args.clear();
+        m_texts.clear();
+        m_paints.clear();
+        m_textStyles.clear();
+        m_images.clear();
+    }
+
+/* ------------------- Basic Path ----------------------*/
+
+    DisplayList& DisplayList::moveTo(float x,float y)
+    {
+        return push(Op::MoveTo,{x,y});
+    }
+
+    DisplayList& DisplayList::lineTo(float x,float y)
+    {
+        return push(Op::LineTo,{x,y});
+    }
+
+    DisplayList& DisplayList::arcTo(float x1,float y1,float x2,float y2,float r)
+    {
+        return push(Op::ArcTo,{x1,y1,x2,y2,r});
+    }
+
+    DisplayList& DisplayList::quadraticCurveTo(float cpx,float cpy,float x, float y)
+    {
+        return push(Op::QuadTo,{cpx,cpy,x,y});
+    }
+
+    DisplayList& DisplayList::bezierCurveTo(float cp1x,float cp1y,
+                                            float cp2x,float cp2y,
+                                            float x, float y)
+    {
+        return push(Op::BezierTo,{cp1x,cp1y,cp2x,cp2y,x,y});
+    }
+
+    DisplayList& DisplayList::arc(float x,float y,float r,
+                                  float sAngle,float eAngle,bool counterclockwise)
+    {
+        return push(Op::Arc,{x,y,r,sAngle,eAngle},counterclockwise);
+    }
+
+    DisplayList& DisplayList::closePath()
+    {
+        return push(Op::ClosePath,{});
+    }
+
+/* ------------------- Advance Path --------------------*/
+
+    DisplayList& DisplayList::rect(float x,float y,float w,float h)
+    {
+        return push(Op::Rect,{x,y,w,h});
+    }
+
+    DisplayList& DisplayList::roundedRect(float x,float y,float w,float h,float r)
+    {
+        return push(Op::RoundedRect,{x,y,w,h,r});
+    }
+
+    DisplayList& DisplayList::circle(float cx ,float cy , float r)
+    {
+        return push(Op::Circle,{cx,cy,r});
+    }
+
+    DisplayList& DisplayList::ellipse(float cx, float cy, float rx, float ry)
+    {
+        return push(Op::Ellipse,{cx,cy,rx,ry});
+    }
+
+/* ------------------- Draw Action ---------------------*/
+
+    DisplayList& DisplayList::fill()
+    {
+        return push(Op::Fill,{});
+    }
+
+    DisplayList& DisplayList::stroke()
+    {
+        return push(Op::Stroke,{});
+    }
+
+    DisplayList& DisplayList::fillRect(float x,float y,float w,float h)
+    {
+        return push(Op::FillRect,{x,y,w,h});
+    }
+
+    DisplayList& DisplayList::strokeRect(float x,float y,float w,float h)
+    {
+        return push(Op::StrokeRect,{x,y,w,h});
+    }
+
+    DisplayList& DisplayList::clearColor(const Color& color)
+    {
+        return push(Op::ClearColor,{},color.code());
+    }
+
+    DisplayList& DisplayList::fillText(const string& text,float x,float y,float rowWidth)
+    {
+        m_texts.push_back(text);
+        return push(Op::FillText,{x,y,rowWidth},(unsigned)m_texts.size()-1);
+    }
+
+    DisplayList& DisplayList::drawImage(Image& image,float x,float y,
+                                        float width,float height,
+                                        float sx,float sy,float swidth,float sheight)
+    {
+        m_images.push_back(&image);
+        return push(Op::DrawImage,{x,y,width,height,sx,sy,swidth,sheight},
+                    (unsigned)m_images.size()-1);
+    }
+
+/*-------------------- Style Control -------------------*/
+
+    DisplayList& DisplayList::lineCap(Canvas::LineCap cap)
+    {
+        return push(Op::LineCap,{},(unsigned)cap);
+    }
+
+    DisplayList& DisplayList::lineJoin(Canvas::LineJoin join)
+    {
+        return push(Op::LineJoin,{},(unsigned)join);
+    }
+
+    DisplayList& DisplayList::lineWidth(float width)
+    {
+        return push(Op::LineWidth,{width});
+    }
+
+    DisplayList& DisplayList::miterLimit(float limit)
+    {
+        return push(Op::MiterLimit,{limit});
+    }
+
+    DisplayList& DisplayList::globalAlpha(float alpha)
+    {
+        return push(Op::GlobalAlpha,{alpha});
+    }
+
+    DisplayList& DisplayList::fillStyle(const Color& color)
+    {
+        return push(Op::FillColor,{},color.code());
+    }
+
+    DisplayList& DisplayList::fillStyle(const Paint& paint)
+    {
+        m_paints.push_back(paint);
+        return push(Op::FillPaint,{},(unsigned)m_paints.size()-1);
+    }
+
+    DisplayList& DisplayList::strokeStyle(const Color& color)
+    {
+        return push(Op::StrokeColor,{},color.code());
+    }
+
+    DisplayList& DisplayList::strokeStyle(const Paint& paint)
+    {
+        m_paints.push_back(paint);
+        return push(Op::StrokePaint,{},(unsigned)m_paints.size()-1);
+    }
+
+    DisplayList& DisplayList::font(const Font& font)
+    {
+        if(font.valid())
+            push(Op::FontFace,{},(unsigned)font.face);
+        return *this;
+    }
+
+    DisplayList& DisplayList::font(float size)
+    {
+        return push(Op::FontSize,{size});
+    }
+
+    DisplayList& DisplayList::textAlign( HorizontalAlign hAlign,VerticalAlign vAlign)
+    {
+        return push(Op::TextAlign,{},(unsigned)(hAlign|vAlign));
+    }
+
+    DisplayList& DisplayList::fillStyle(const TextStyle& textStyle)
+    {
+        m_textStyles.push_back(textStyle);
+        return push(Op::TextStyle,{},(unsigned)m_textStyles.size()-1);
+    }
+
+/*--------------------- Transformations ----------------*/
+
+    DisplayList& DisplayList::scale(float scalewidth , float scaleheight)
+    {
+        return push(Op::Scale,{scalewidth,scaleheight});
+    }
+
+    DisplayList& DisplayList::rotate(float angle)
+    {
+        return push(Op::Rotate,{angle});
+    }
+
+    DisplayList& DisplayList::translate(float x,float y)
+    {
+        return push(Op::Translate,{x,y});
+    }
+
+    DisplayList& DisplayList::transform(float a, float b, float c,
+                                        float d, float e, float f)
+    {
+        return push(Op::Transform,{a,b,c,d,e,f});
+    }
+
+    DisplayList& DisplayList::setTransform(float a, float b, float c,
+                                           float d, float e, float f)
+    {
+        return push(Op::SetTransform,{a,b,c,d,e,f});
+    }
+
+    DisplayList& DisplayList::restTransform()
+    {
+        return push(Op::ResetTransform,{});
+    }
+
+/*---------------- Canvas Control -----------------*/
+
+    DisplayList& DisplayList::beginPath()
+    {
+        return push(Op::BeginPath,{});
+    }
+
+    DisplayList& DisplayList::pathWinding( Canvas::Winding dir)
+    {
+        return push(Op::PathWinding,{},(unsigned)dir);
+    }
+
+    DisplayList& DisplayList::clip(float x,float y,float w,float h)
+    {
+        return push(Op::Clip,{x,y,w,h});
+    }
+
+    DisplayList& DisplayList::resetClip()
+    {
+        return push(Op::ResetClip,{});
+    }
+
+    DisplayList& DisplayList::save()
+    {
+        return push(Op::Save,{});
+    }
+
+    DisplayList& DisplayList::restore()
+    {
+        return push(Op::Restore,{});
+    }
+
+    DisplayList& DisplayList::reset()
+    {
+        return push(Op::Reset,{});
+    }
+
+/*------------------- Replay -----------------*/
+
+    Canvas& Canvas::replay(const DisplayList& list)
+    {
+        NANOCANVAS_TIMER;
+        using Op = DisplayList::Op;
+        const float* args = list.m_args.data();
+        for( const DisplayList::Command& cmd : list.m_commands )
+        {
+            const float* a = args + cmd.args;
+            switch(cmd.op)
+            {
+                case Op::MoveTo:      moveTo(a[0],a[1]); break;
+                case Op::LineTo:      lineTo(a[0],a[1]); break;
+                case Op::ArcTo:       arcTo(a[0],a[1],a[2],a[3],a[4]); break;
+                case Op::QuadTo:      quadraticCurveTo(a[0],a[1],a[2],a[3]); break;
+                case Op::BezierTo:    bezierCurveTo(a[0],a[1],a[2],a[3],a[4],a[5]); break;
+                case Op::Arc:         arc(a[0],a[1],a[2],a[3],a[4],cmd.ref != 0U); break;
+                case Op::ClosePath:   closePath(); break;
+                case Op::Rect:        rect(a[0],a[1],a[2],a[3]); break;
+                case Op::RoundedRect: roundedRect(a[0],a[1],a[2],a[3],a[4]); break;
+                case Op::Circle:      circle(a[0],a[1],a[2]); break;
+                case Op::Ellipse:     ellipse(a[0],a[1],a[2],a[3]); break;
+                case Op::Fill:        fill(); break;
+                case Op::Stroke:      stroke(); break;
+                case Op::FillRect:    fillRect(a[0],a[1],a[2],a[3]); break;
+                case Op::StrokeRect:  strokeRect(a[0],a[1],a[2],a[3]); break;
+                case Op::ClearColor:  clearColor(Color(cmd.ref)); break;
+                case Op::FillText:
+                    fillText(list.m_texts[cmd.ref],a[0],a[1],a[2]);
+                    break;
+                case Op::DrawImage:
+                    drawImage(*list.m_images[cmd.ref],a[0],a[1],a[2],a[3],
+                              a[4],a[5],a[6],a[7]);
+                    break;
+                case Op::LineCap:     lineCap((LineCap)cmd.ref); break;
+                case Op::LineJoin:    lineJoin((LineJoin)cmd.ref); break;
+                case Op::LineWidth:   lineWidth(a[0]); break;
+                case Op::MiterLimit:  miterLimit(a[0]); break;
+                case Op::GlobalAlpha: globalAlpha(a[0]); break;
+                case Op::FillColor:   fillStyle(Color(cmd.ref)); break;
+                case Op::FillPaint:   fillStyle(list.m_paints[cmd.ref]); break;
+                case Op::StrokeColor: strokeStyle(Color(cmd.ref)); break;
+                case Op::StrokePaint: strokeStyle(list.m_paints[cmd.ref]); break;
+                case Op::FontFace:    fontFace((int)cmd.ref); break;
+                case Op::FontSize:    font(a[0]); break;
+                case Op::TextAlign:
+                    textAlign((HorizontalAlign)(cmd.ref & (Left|Center|Right)),
+                              (VerticalAlign)(cmd.ref & ~(unsigned)(Left|Center|Right)));
+                    break;
+                case Op::TextStyle:   fillStyle(list.m_textStyles[cmd.ref]); break;
+                case Op::Scale:       scale(a[0],a[1]); break;
+                case Op::Rotate:      rotate(a[0]); break;
+                case Op::Translate:   translate(a[0],a[1]); break;
+                case Op::Transform:   transform(a[0],a[1],a[2],a[3],a[4],a[5]); break;
+                case Op::SetTransform:setTransform(a[0],a[1],a[2],a[3],a[4],a[5]); break;
+                case Op::ResetTransform: restTransform(); break;
+                case Op::BeginPath:   beginPath(); break;
+                case Op::PathWinding: pathWinding((Winding)cmd.ref); break;
+                case Op::Clip:        clip(a[0],a[1],a[2],a[3]); break;
+                case Op::ResetClip:   resetClip(); break;
+                case Op::Save:        save(); break;
+                case Op::Restore:     restore(); break;
+                case Op::Reset:       reset(); break;
+            }
+        }
+        return *this;
+    }
+}
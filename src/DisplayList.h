@@ -0,0 +1,229 @@
+#ifndef DISPLAYLIST_H
+#define DISPLAYLIST_H
+
+namespace NanoCanvas
+{
+    /**
+     * @class DisplayList
+     * @brief Records a sequence of Canvas calls to be replayed later
+     *
+     * A display list has the same drawing API as the Canvas, but nothing is drawn
+     * while recording. The calls are stored into a compact flat command buffer and
+     * submitted in one tight loop by Canvas::replay(). Mostly static content can be
+     * recorded once and replayed each frame.
+     *
+     * @note Images and fonts are referenced, not copied. They must stay alive as long as the list is replayed.
+     * @see Canvas::replay
+     */
+    class DisplayList
+    {
+    public:
+        DisplayList() = default;
+
+    /* ------------------- Basic Path ----------------------*/
+
+        /// @see Canvas::moveTo
+        DisplayList& moveTo(float x,float y);
+
+        /// @see Canvas::lineTo
+        DisplayList& lineTo(float x,float y);
+
+        /// @see Canvas::arcTo
+        DisplayList& arcTo(float x1,float y1,float x2,float y2,float r);
+
+        /// @see Canvas::quadraticCurveTo
+        DisplayList& quadraticCurveTo(float cpx,float cpy,float x, float y);
+
+        /// @see Canvas::bezierCurveTo
+        DisplayList& bezierCurveTo(float cp1x,float cp1y,
+                                   float cp2x,float cp2y,
+                                   float x, float y);
+
+        /// @see Canvas::arc
+        DisplayList& arc(float x,float y,float r,
+                         float sAngle,float eAngle,bool counterclockwise = false);
+
+        /// @see Canvas::closePath
+        DisplayList& closePath();
+
+    /* ------------------- Advance Path --------------------*/
+
+        /// @see Canvas::rect
+        DisplayList& rect(float x,float y,float w,float h);
+
+        /// @see Canvas::roundedRect
+        DisplayList& roundedRect(float x,float y,float w,float h,float r);
+
+        /// @see Canvas::circle
+        DisplayList& circle(float cx ,float cy , float r);
+
+        /// @see Canvas::ellipse
+        DisplayList& ellipse(float cx, float cy, float rx, float ry);
+
+    /* ------------------- Draw Action ---------------------*/
+
+        /// @see Canvas::fill
+        DisplayList& fill();
+
+        /// @see Canvas::stroke
+        DisplayList& stroke();
+
+        /// @see Canvas::fillRect
+        DisplayList& fillRect(float x,float y,float w,float h);
+
+        /// @see Canvas::strokeRect
+        DisplayList& strokeRect(float x,float y,float w,float h);
+
+        /// @see Canvas::clearColor
+        DisplayList& clearColor(const Color& color);
+
+        /// @see Canvas::fillText
+        DisplayList& fillText(const string& text,float x,float y,float rowWidth = NAN);
+
+        /// @see Canvas::drawImage
+        DisplayList& drawImage(Image& image,float x,float y,
+                               float width = NAN,float height = NAN,
+                               float sx = 0,float sy = 0,
+                               float swidth = NAN,float sheight = NAN);
+
+    /*-------------------- Style Control -------------------*/
+
+        /// @see Canvas::lineCap
+        DisplayList& lineCap(Canvas::LineCap cap);
+
+        /// @see Canvas::lineJoin
+        DisplayList& lineJoin(Canvas::LineJoin join);
+
+        /// @see Canvas::lineWidth
+        DisplayList& lineWidth(float width);
+
+        /// @see Canvas::miterLimit
+        DisplayList& miterLimit(float limit);
+
+        /// @see Canvas::globalAlpha
+        DisplayList& globalAlpha(float alpha);
+
+        /// @see Canvas::fillStyle(const Color&)
+        DisplayList& fillStyle(const Color& color);
+
+        /// @see Canvas::fillStyle(const Paint&)
+        DisplayList& fillStyle(const Paint& paint);
+
+        /// @see Canvas::strokeStyle(const Color&)
+        DisplayList& strokeStyle(const Color& color);
+
+        /// @see Canvas::strokeStyle(const Paint&)
+        DisplayList& strokeStyle(const Paint& paint);
+
+        /// @see Canvas::font(const Font&)
+        DisplayList& font(const Font& font);
+
+        /// @see Canvas::font(float)
+        DisplayList& font(float size);
+
+        /// @see Canvas::textAlign
+        DisplayList& textAlign( HorizontalAlign hAlign,VerticalAlign vAlign);
+
+        /// @see Canvas::fillStyle(const TextStyle&)
+        DisplayList& fillStyle(const TextStyle& textStyle);
+
+    /*--------------------- Transformations ----------------*/
+
+        /// @see Canvas::scale
+        DisplayList& scale(float scalewidth , float scaleheight);
+
+        /// @see Canvas::rotate
+        DisplayList& rotate(float angle);
+
+        /// @see Canvas::translate
+        DisplayList& translate(float x,float y);
+
+        /// @see Canvas::transform
+        DisplayList& transform(float a, float b, float c, float d, float e, float f);
+
+        /// @see Canvas::setTransform
+        DisplayList& setTransform(float a, float b, float c, float d, float e, float f);
+
+        /// @see Canvas::restTransform
+        DisplayList& restTransform();
+
+    /*--------------------- Canvas Control -----------------*/
+
+        /// @see Canvas::beginPath
+        DisplayList& beginPath();
+
+        /// @see Canvas::pathWinding
+        DisplayList& pathWinding( Canvas::Winding dir);
+
+        /// @see Canvas::clip
+        DisplayList& clip(float x,float y,float w,float h);
+
+        /// @see Canvas::resetClip
+        DisplayList& resetClip();
+
+        /// @see Canvas::save
+        DisplayList& save();
+
+        /// @see Canvas::restore
+        DisplayList& restore();
+
+        /// @see Canvas::reset
+        DisplayList& reset();
+
+    /*------------------ Display list propoties ---------------*/
+
+        /// Remove all recorded commands, the reserved memory is kept for recording again
+        void clear();
+
+        /// Check is there no command recorded
+        inline bool empty()const { return m_commands.empty(); }
+
+        /// Get the count of recorded commands
+        inline size_t size()const { return m_commands.size(); }
+
+    private:
+        friend class Canvas;
+
+        /// The operation code of recorded commands
+        enum class Op : unsigned char
+        {
+            MoveTo, LineTo, ArcTo, QuadTo, BezierTo, Arc, ClosePath,
+            Rect, RoundedRect, Circle, Ellipse,
+            Fill, Stroke, FillRect, StrokeRect, ClearColor, FillText, DrawImage,
+            LineCap, LineJoin, LineWidth, MiterLimit, GlobalAlpha,
+            FillColor, FillPaint, StrokeColor, StrokePaint,
+            FontFace, FontSize, TextAlign, TextStyle,
+            Scale, Rotate, Translate, Transform, SetTransform, ResetTransform,
+            BeginPath, PathWinding, Clip, ResetClip, Save, Restore, Reset
+        };
+
+        /// A recorded command
+        struct Command
+        {
+            /// The operation of the command
+            Op op;
+            /// Offset of the first argument in the argument buffer
+            unsigned args;
+            /// Color code, enum value or index in resource pools
+            unsigned ref;
+        };
+
+        /// Record a command with its float arguments
+        DisplayList& push(Op op,std::initializer_list<float> args,unsigned ref = 0U);
+
+        /// The recorded commands
+        std::vector<Command>   m_commands;
+        /// Float arguments of all commands
+        std::vector<float>     m_args;
+        /// Texts used by fillText commands
+        std::vector<string>    m_texts;
+        /// Paints used by paint style commands
+        std::vector<Paint>     m_paints;
+        /// Text styles used by text style commands
+        std::vector<TextStyle> m_textStyles;
+        /// Images used by drawImage commands
+        std::vector<Image*>    m_images;
+    };
+}
+
+#endif // DISPLAYLIST_H
@@ -0,0 +1,59 @@
+#include "NanoCanvas.h"
+#include "nanovg.h"
+
+namespace NanoCanvas
+{
+    FrameArena::FrameArena(size_t blockSize)
+    {
+        m_blockSize = std::max(blockSize,(size_t)64);
+    }
+
+    FrameArena::~FrameArena()
+    {
+        for( auto& block : m_blocks )
+            delete[] block.data;
+    }
+
+    void* FrameArena::allocate(size_t size,size_t alignment)
+    {
+        while( m_current < m_blocks.size() )
+        {
+            const Block& block = m_blocks[m_current];
+            size_t offset = ( (size_t)( block.data + m_offset ) + alignment - 1 ) & ~( alignment - 1 );
+            offset -= (size_t)block.data;
+            if( offset + size <= block.size )
+            {
+                m_used += offset + size - m_offset;
+                m_offset = offset + size;
+                return block.data + offset;
+            }
+            ++m_current;
+            m_offset = 0;
+        }
+
+        Block block;
+        block.size = std::max(m_blockSize,size + alignment);
+        block.data = new unsigned char[block.size];
+        m_blocks.push_back(block);
+        m_capacity += block.size;
+        m_current = m_blocks.size() - 1;
+        m_offset = 0;
+        return allocate(size,alignment);
+    }
+
+    void FrameArena::reset()
+    {
+        // A frame which needed several blocks gets one block large enough for all of them
+        if( m_blocks.size() > 1 )
+        {
+            for( auto& block : m_blocks )
+                delete[] block.data;
+            m_blocks.resize(1);
+            m_blocks[0].size = m_capacity;
+            m_blocks[0].data = new unsigned char[m_capacity];
+        }
+        m_current = 0;
+        m_offset = 0;
+        m_used = 0;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+namespace NanoCanvas
+{
+    /**
+     * @class FrameArena
+     * @brief A bump allocator for scratch memory living until the next frame
+     *
+     * Allocating is only moving an offset, all the memory is released at once by reset().
+     * The blocks are kept, and merged into one block if a frame needed more than one,
+     * so steady frames don't touch the heap.
+     * @code
+     * // Inside a frame
+     * float* points = canvas.frameArena().allocate<float>(count*2);
+     * @endcode
+     * @attention No constructors and destructors are called, use it for plain data only.
+     */
+    class FrameArena
+    {
+    public:
+        /**
+         * @brief Create an empty arena
+         * @param blockSize The size of the first block, allocated on the first use
+         */
+        explicit FrameArena(size_t blockSize = 64UL << 10);
+
+        ~FrameArena();
+
+        /// Delete copy constructor
+        FrameArena(const FrameArena&) = delete;
+        /// Disable assignment
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        /**
+         * @brief Allocate a chunk of memory until the next reset
+         * @param size The size of the chunk in bytes
+         * @param alignment The alignment of the chunk, must be a power of 2
+         * @return The chunk of memory
+         */
+        void* allocate(size_t size,size_t alignment = sizeof(double));
+
+        /**
+         * @brief Allocate an uninitialized array until the next reset
+         * @param count The count of elements
+         * @return The first element of the array
+         */
+        template<typename T>
+        inline T* allocate(size_t count)
+        {
+            return (T*)allocate(sizeof(T)*count,alignof(T));
+        }
+
+        /// Release all the chunks, the memory is kept for reuse
+        void reset();
+
+        /// The bytes allocated since the last reset
+        inline size_t used()const { return m_used; }
+
+        /// The bytes of all the blocks
+        inline size_t capacity()const { return m_capacity; }
+
+    private:
+        /// A chunk of heap memory
+        struct Block
+        {
+            unsigned char * data;
+            size_t size;
+        };
+
+        std::vector<Block> m_blocks;
+        /// The block to allocate from
+        size_t m_current = 0;
+        /// The offset of free memory in the current block
+        size_t m_offset = 0;
+        size_t m_blockSize;
+        size_t m_used = 0;
+        size_t m_capacity = 0;
+    };
+}
+
+#endif // FRAMEARENA_H
@@ -0,0 +1,143 @@
+#include "NanoCanvas.h"
+#include "nanovg.h"
+
+namespace NanoCanvas
+{
+    /// The max count of cells, large areas get larger cells
+    static const int MaxHitCells = 1 << 14;
+
+    HitGrid::HitGrid(float cellSize)
+    {
+        m_baseCellSize = m_cellSize = cellSize >= 1.0f ? cellSize : 32.0f;
+        m_cells.resize(1);
+    }
+
+    void HitGrid::reset(float x,float y,float width,float height)
+    {
+        m_shapes.clear();
+        m_dropped.clear();
+        for( auto& cell : m_cells )
+            cell.clear();
+        width = std::max(width,1.0f);
+        height = std::max(height,1.0f);
+        float cellSize = m_baseCellSize;
+        while( std::ceil(width/cellSize)*std::ceil(height/cellSize) > MaxHitCells )
+            cellSize *= 2.0f;
+        int columns = (int)std::ceil(width/cellSize);
+        int rows = (int)std::ceil(height/cellSize);
+        m_x = x;
+        m_y = y;
+        if( columns != m_columns || rows != m_rows )
+        {
+            m_columns = columns;
+            m_rows = rows;
+            m_cells.resize((size_t)columns*rows);
+        }
+        m_cellSize = cellSize;
+    }
+
+    void HitGrid::insert(float minx,float miny,float maxx,float maxy,unsigned id)
+    {
+        if( !id || !( minx <= maxx && miny <= maxy ) )
+            return;
+        // Shapes out of the grid can't be queried
+        float gridx1 = m_x + m_columns*m_cellSize;
+        float gridy1 = m_y + m_rows*m_cellSize;
+        if( maxx < m_x || maxy < m_y || minx > gridx1 || miny > gridy1 )
+            return;
+
+        Shape shape = { minx, miny, maxx, maxy, id, false };
+        // A redrawn shape goes back to the earliest dropped place of its id
+        auto best = m_dropped.end();
+        for( auto it = m_dropped.begin() ; it != m_dropped.end() ; ++it )
+            if( m_shapes[*it].id == id && ( best == m_dropped.end() || *it < *best ) )
+                best = it;
+        unsigned index;
+        if( best != m_dropped.end() )
+        {
+            index = *best;
+            m_dropped.erase(best);
+            m_shapes[index] = shape;
+        }
+        else
+        {
+            index = (unsigned)m_shapes.size();
+            m_shapes.push_back(shape);
+        }
+        link(index);
+    }
+
+    void HitGrid::remove(float minx,float miny,float maxx,float maxy)
+    {
+        compact();
+        for( unsigned index = 0 ; index < m_shapes.size() ; ++index )
+        {
+            Shape& shape = m_shapes[index];
+            if( shape.maxx < minx || shape.maxy < miny || shape.minx > maxx || shape.miny > maxy )
+                continue;
+            shape.dropped = true;
+            m_dropped.push_back(index);
+            int c0,r0,c1,r1;
+            cellOf(shape.minx,shape.miny,c0,r0);
+            cellOf(shape.maxx,shape.maxy,c1,r1);
+            for( int r = r0 ; r <= r1 ; ++r )
+                for( int c = c0 ; c <= c1 ; ++c )
+                {
+                    std::vector<unsigned>& cell = m_cells[(size_t)r*m_columns + c];
+                    cell.erase(std::remove(cell.begin(),cell.end(),index),cell.end());
+                }
+        }
+    }
+
+    void HitGrid::link(unsigned index)
+    {
+        const Shape& shape = m_shapes[index];
+        int c0,r0,c1,r1;
+        cellOf(shape.minx,shape.miny,c0,r0);
+        cellOf(shape.maxx,shape.maxy,c1,r1);
+        for( int r = r0 ; r <= r1 ; ++r )
+            for( int c = c0 ; c <= c1 ; ++c )
+            {
+                std::vector<unsigned>& cell = m_cells[(size_t)r*m_columns + c];
+                if( cell.empty() || cell.back() < index )
+                    cell.push_back(index);
+                else
+                    cell.insert(std::upper_bound(cell.begin(),cell.end(),index),index);
+            }
+    }
+
+    void HitGrid::compact()
+    {
+        if( m_dropped.empty() )
+            return;
+        m_remap.resize(m_shapes.size());
+        unsigned count = 0;
+        for( unsigned index = 0 ; index < m_shapes.size() ; ++index )
+        {
+            m_remap[index] = count;
+            if( !m_shapes[index].dropped )
+                m_shapes[count++] = m_shapes[index];
+        }
+        m_shapes.resize(count);
+        m_dropped.clear();
+        // The cells only hold shapes kept, the order doesn't change
+        for( auto& cell : m_cells )
+            for( auto& index : cell )
+                index = m_remap[index];
+    }
+
+    unsigned HitGrid::query(float x,float y)const
+    {
+        int column,row;
+        cellOf(x,y,column,row);
+        const std::vector<unsigned>& cell = m_cells[(size_t)row*m_columns + column];
+        // The indices are in drawing order, the last one is on the top
+        for( auto it = cell.rbegin() ; it != cell.rend() ; ++it )
+        {
+            const Shape& shape = m_shapes[*it];
+            if( x >= shape.minx && x <= shape.maxx && y >= shape.miny && y <= shape.maxy )
+                return shape.id;
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef HITGRID_H
+#define HITGRID_H
+
+namespace NanoCanvas
+{
+    /**
+     * @class HitGrid
+     * @brief A uniform grid of shape bounds to find the shape under a point
+     *
+     * Each shape is linked into the cells its bounds overlap, so a query only tests the shapes
+     * of one cell. The cells keep their memory after clear(), steady frames don't touch the heap.
+     * @see Canvas::setHitID
+     */
+    class HitGrid
+    {
+    public:
+        /**
+         * @brief Create an empty grid
+         * @param cellSize The width and height of the cells, in pixels
+         */
+        explicit HitGrid(float cellSize = 32.0f);
+
+        /**
+         * @brief Remove all the shapes and cover a new area
+         * @param x The x-coordinate of the area
+         * @param y The y-coordinate of the area
+         * @param width The width of the area
+         * @param height The height of the area
+         */
+        void reset(float x,float y,float width,float height);
+
+        /**
+         * @brief Add a shape, shapes added later are above the earlier ones
+         *
+         * A shape dropped by remove() with the same id takes back its place in the order.
+         * @param id The id of the shape, 0 is ignored
+         */
+        void insert(float minx,float miny,float maxx,float maxy,unsigned id);
+
+        /**
+         * @brief Drop the shapes whose bounds intersect an area, to be added again when redrawn
+         *
+         * The shapes dropped before and not added again are removed for good.
+         */
+        void remove(float minx,float miny,float maxx,float maxy);
+
+        /**
+         * @brief Find the topmost shape whose bounds contain a point
+         * @return The id of the shape, 0 if there is none
+         */
+        unsigned query(float x,float y)const;
+
+        /// The count of shapes
+        inline size_t size()const { return m_shapes.size() - m_dropped.size(); }
+
+    private:
+        /// The bounds of a shape
+        struct Shape
+        {
+            float minx;
+            float miny;
+            float maxx;
+            float maxy;
+            unsigned id;
+            /// Is the shape dropped by remove()
+            bool dropped;
+        };
+
+        /// Link a shape into the cells its bounds overlap, keeping the cells in drawing order
+        void link(unsigned index);
+
+        /// Remove the dropped shapes and renumber the others
+        void compact();
+
+        /// Get the cell containing a point, clamped to the grid
+        inline void cellOf(float x,float y,int& column,int& row)const
+        {
+            column = clamp((int)std::floor( ( x - m_x ) / m_cellSize ),0,m_columns - 1);
+            row = clamp((int)std::floor( ( y - m_y ) / m_cellSize ),0,m_rows - 1);
+        }
+
+        std::vector<Shape> m_shapes;
+        /// The indices of the dropped shapes
+        std::vector<unsigned> m_dropped;
+        /// The new indices of the shapes while compacting
+        std::vector<unsigned> m_remap;
+        /// The indices of the shapes overlapping each cell, row by row
+        std::vector<std::vector<unsigned>> m_cells;
+        /// The cell size asked for
+        float m_baseCellSize;
+        /// The cell size of the current area
+        float m_cellSize;
+        float m_x = 0.0f;
+        float m_y = 0.0f;
+        int m_columns = 1;
+        int m_rows = 1;
+    };
+}
+
+#endif // HITGRID_H
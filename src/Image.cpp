@@ -6,14 +6,17 @@ namespace NanoCanvas
     Image::Image(Canvas& canvas,const string& filePath, int imageFlags)
     {
         m_canvas = &canvas;
-        auto vg = canvas.nvgContext();
+        auto vg = canvas.imageContext();
         if(vg && filePath.length() )
             imageID = nvgCreateImage(vg,filePath.c_str(),imageFlags);
+        m_filePath = filePath;
+        m_imageFlags = imageFlags;
     }
     Image::Image(Canvas& canvas,const Memery& memory, int imageFlags)
     {
         m_canvas = &canvas;
-        auto vg = canvas.nvgContext();
+        m_imageFlags = imageFlags;
+        auto vg = canvas.imageContext();
         if(vg && memory.valid() )
         {
             imageID = nvgCreateImageMem(vg,imageFlags,
@@ -25,7 +28,8 @@ namespace NanoCanvas
     Image::Image(Canvas& canvas,int w,int h,const Memery& memory,int imageFlags)
     {
         m_canvas = &canvas;
-        auto vg = canvas.nvgContext();
+        m_imageFlags = imageFlags;
+        auto vg = canvas.imageContext();
         if(vg && memory.valid() )
         {
             imageID = nvgCreateImageRGBA(vg,w,h,imageFlags,
@@ -37,7 +41,7 @@ namespace NanoCanvas
     {
         if(m_canvas)
         {
-            auto vg = m_canvas->nvgContext();
+            auto vg = m_canvas->imageContext();
             if(vg)
                 nvgDeleteImage(vg,imageID);
         }
@@ -47,7 +51,7 @@ namespace NanoCanvas
     {
         if(m_canvas)
         {
-            auto vg = m_canvas->nvgContext();
+            auto vg = m_canvas->imageContext();
             if(vg)
                 nvgUpdateImage(vg,imageID,(const unsigned char*)(memory.data));
         }
@@ -57,7 +61,7 @@ namespace NanoCanvas
     {
         if(m_canvas)
         {
-            auto vg = m_canvas->nvgContext();
+            auto vg = m_canvas->imageContext();
             if(vg)
                 nvgImageSize(vg,imageID,&width,&height);
         }
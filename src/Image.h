@@ -85,8 +85,14 @@ namespace NanoCanvas
         /// The image id of nanovg
         int imageID = 0;
     private:
+        friend class Canvas;
+        
         /// The owner canvas
         Canvas * m_canvas = nullptr;
+        /// The file loaded from, to load it again in offscreen layers
+        string m_filePath;
+        /// The creation flags
+        int m_imageFlags = 0;
     };
 }
 
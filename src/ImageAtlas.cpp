@@ -0,0 +1,320 @@
+#include "NanoCanvas.h"
+#include "nanovg.h"
+#include <cstring>
+
+namespace NanoCanvas
+{
+    /// Pixels around each image filled with its edges, avoid bleeding of neighbours when filtered
+    static const int AtlasPadding = 1;
+
+    /// The fragmentation which triggers a repack when an image doesn't fit
+    static const float AtlasRepackThreshold = 0.25f;
+
+    ImageAtlas::ImageAtlas(Canvas& canvas,int pageWidth,int pageHeight,int imageFlags)
+    {
+        m_canvas = &canvas;
+        m_pageWidth = std::max(pageWidth,1);
+        m_pageHeight = std::max(pageHeight,1);
+        m_imageFlags = imageFlags;
+    }
+
+    ImageAtlas::~ImageAtlas()
+    {
+        auto vg = m_canvas->imageContext();
+        if(vg)
+        {
+            for( auto& page : m_pages )
+                if( page.imageID )
+                    nvgDeleteImage(vg,page.imageID);
+        }
+    }
+
+    SubImage ImageAtlas::insert(int w,int h,const Memery& memory)
+    {
+        SubImage image;
+        if( w <= 0 || h <= 0 || !memory.valid() || memory.size < (unsigned long)w*h*4 )
+            return image;
+        int pw = w + AtlasPadding*2;
+        int ph = h + AtlasPadding*2;
+        if( pw > m_pageWidth || ph > m_pageHeight )
+            return image;
+
+        unsigned page = 0;
+        int x = 0,y = 0;
+        bool placed = place(pw,ph,page,x,y);
+        if( !placed && fragmentation() > AtlasRepackThreshold )
+        {
+            repack();
+            placed = place(pw,ph,page,x,y);
+        }
+        if( !placed )
+        {
+            page = m_pages.size();
+            if( !pack(addPage(),pw,ph,x,y) )
+            {
+                m_pages.pop_back();
+                return image;
+            }
+        }
+
+        blit(m_pages[page],x,y,w,h,(const unsigned char*)memory.data,w*4);
+        m_usedArea += (long)pw*ph;
+
+        Entry entry;
+        entry.page = page;
+        entry.x = x + AtlasPadding;
+        entry.y = y + AtlasPadding;
+        entry.w = w;
+        entry.h = h;
+        entry.alive = true;
+        m_entries.push_back(entry);
+
+        image.atlas = this;
+        image.id = m_entries.size();
+        return image;
+    }
+
+    void ImageAtlas::remove(const SubImage& image)
+    {
+        if( image.atlas != this || !image.id || image.id > m_entries.size() )
+            return;
+        Entry& entry = m_entries[image.id-1];
+        if( entry.alive )
+        {
+            entry.alive = false;
+            long area = (long)(entry.w + AtlasPadding*2)*(entry.h + AtlasPadding*2);
+            m_usedArea -= area;
+            m_wastedArea += area;
+        }
+    }
+
+    void ImageAtlas::repack()
+    {
+        std::vector<unsigned> order;
+        for( unsigned i = 0 ; i < m_entries.size() ; ++i )
+            if( m_entries[i].alive )
+                order.push_back(i);
+        // Tall images first give the skyline flatter levels
+        std::sort(order.begin(),order.end(),[this](unsigned a,unsigned b)
+        {
+            const Entry& ea = m_entries[a];
+            const Entry& eb = m_entries[b];
+            return ea.h != eb.h ? ea.h > eb.h : ea.w > eb.w;
+        });
+
+        std::vector<Page> old;
+        old.swap(m_pages);
+        for( unsigned i : order )
+        {
+            Entry& entry = m_entries[i];
+            int pw = entry.w + AtlasPadding*2;
+            int ph = entry.h + AtlasPadding*2;
+            unsigned page = 0;
+            int x = 0,y = 0;
+            if( !place(pw,ph,page,x,y) )
+            {
+                page = m_pages.size();
+                Page& fresh = addPage();
+                // Keep the textures of the old pages
+                if( page < old.size() )
+                    fresh.imageID = old[page].imageID;
+                if( !pack(fresh,pw,ph,x,y) )
+                {
+                    // Images larger than a page are never inserted, drop it rather than overlap
+                    entry.alive = false;
+                    m_usedArea -= (long)pw*ph;
+                    continue;
+                }
+            }
+            const Page& from = old[entry.page];
+            const unsigned char* src = &from.pixels[((size_t)entry.y*m_pageWidth + entry.x)*4];
+            blit(m_pages[page],x,y,entry.w,entry.h,src,m_pageWidth*4);
+            entry.page = page;
+            entry.x = x + AtlasPadding;
+            entry.y = y + AtlasPadding;
+        }
+
+        auto vg = m_canvas->imageContext();
+        for( size_t i = m_pages.size() ; i < old.size() ; ++i )
+        {
+            if( vg && old[i].imageID )
+                nvgDeleteImage(vg,old[i].imageID);
+        }
+        m_wastedArea = 0;
+    }
+
+    float ImageAtlas::fragmentation()const
+    {
+        long total = m_usedArea + m_wastedArea;
+        return total ? (float)m_wastedArea / total : 0.0f;
+    }
+
+    bool ImageAtlas::locate(const SubImage& image,int& imageID,float* bounds)
+    {
+        if( image.atlas != this || !image.id || image.id > m_entries.size() )
+            return false;
+        const Entry& entry = m_entries[image.id-1];
+        if( !entry.alive )
+            return false;
+
+        Page& page = m_pages[entry.page];
+        if( page.dirty )
+        {
+            auto vg = m_canvas->imageContext();
+            if( !vg )
+                return false;
+            if( page.imageID )
+                nvgUpdateImage(vg,page.imageID,page.pixels.data());
+            else
+                page.imageID = nvgCreateImageRGBA(vg,m_pageWidth,m_pageHeight,
+                                                  m_imageFlags,page.pixels.data());
+            page.dirty = false;
+        }
+        imageID = page.imageID;
+        if( bounds )
+        {
+            bounds[0] = entry.x;
+            bounds[1] = entry.y;
+            bounds[2] = entry.w;
+            bounds[3] = entry.h;
+        }
+        return imageID;
+    }
+
+    const unsigned char* ImageAtlas::pagePixels(int imageID)const
+    {
+        for( const auto& page : m_pages )
+            if( imageID && page.imageID == imageID )
+                return page.pixels.data();
+        return nullptr;
+    }
+
+    void ImageAtlas::size(const SubImage& image,int& width,int& height)const
+    {
+        if( image.atlas == this && image.id && image.id <= m_entries.size() )
+        {
+            const Entry& entry = m_entries[image.id-1];
+            width = entry.w;
+            height = entry.h;
+        }
+    }
+
+    ImageAtlas::Page& ImageAtlas::addPage()
+    {
+        m_pages.push_back(Page());
+        Page& page = m_pages.back();
+        page.pixels.assign((size_t)m_pageWidth*m_pageHeight*4,0);
+        SkylineNode node;
+        node.x = 0;
+        node.y = 0;
+        node.width = m_pageWidth;
+        page.skyline.push_back(node);
+        return page;
+    }
+
+    int ImageAtlas::fits(const Page& page,size_t node,int w,int h)const
+    {
+        const auto& skyline = page.skyline;
+        if( skyline[node].x + w > m_pageWidth )
+            return -1;
+        int y = skyline[node].y;
+        int spaceLeft = w;
+        while( spaceLeft > 0 )
+        {
+            if( node == skyline.size() )
+                return -1;
+            y = std::max(y,skyline[node].y);
+            if( y + h > m_pageHeight )
+                return -1;
+            spaceLeft -= skyline[node].width;
+            ++node;
+        }
+        return y;
+    }
+
+    bool ImageAtlas::pack(Page& page,int w,int h,int& x,int& y)
+    {
+        auto& skyline = page.skyline;
+        int bestHeight = INT_MAX;
+        int bestWidth = INT_MAX;
+        size_t best = skyline.size();
+        // Bottom left rule, the lowest top edge wins and the narrowest node breaks ties
+        for( size_t i = 0 ; i < skyline.size() ; ++i )
+        {
+            int top = fits(page,i,w,h);
+            if( top < 0 )
+                continue;
+            if( top + h < bestHeight || ( top + h == bestHeight && skyline[i].width < bestWidth ) )
+            {
+                best = i;
+                bestWidth = skyline[i].width;
+                bestHeight = top + h;
+                x = skyline[i].x;
+                y = top;
+            }
+        }
+        if( best == skyline.size() )
+            return false;
+
+        // Raise the skyline under the rectangle
+        SkylineNode node;
+        node.x = x;
+        node.y = y + h;
+        node.width = w;
+        skyline.insert(skyline.begin() + best,node);
+        for( size_t i = best + 1 ; i < skyline.size() ; )
+        {
+            int right = skyline[i-1].x + skyline[i-1].width;
+            if( skyline[i].x >= right )
+                break;
+            int shrink = right - skyline[i].x;
+            skyline[i].x += shrink;
+            skyline[i].width -= shrink;
+            if( skyline[i].width > 0 )
+                break;
+            skyline.erase(skyline.begin() + i);
+        }
+        // Merge the neighbours on the same level
+        for( size_t i = 0 ; i + 1 < skyline.size() ; )
+        {
+            if( skyline[i].y == skyline[i+1].y )
+            {
+                skyline[i].width += skyline[i+1].width;
+                skyline.erase(skyline.begin() + i + 1);
+            }
+            else
+                ++i;
+        }
+        page.dirty = true;
+        return true;
+    }
+
+    bool ImageAtlas::place(int w,int h,unsigned& page,int& x,int& y)
+    {
+        for( unsigned i = 0 ; i < m_pages.size() ; ++i )
+        {
+            if( pack(m_pages[i],w,h,x,y) )
+            {
+                page = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ImageAtlas::blit(Page& page,int x,int y,int w,int h,const unsigned char* src,int stride)
+    {
+        for( int row = 0 ; row < h + AtlasPadding*2 ; ++row )
+        {
+            const unsigned char* line = src + clamp(row - AtlasPadding,0,h - 1)*stride;
+            unsigned char* dst = &page.pixels[((size_t)(y + row)*m_pageWidth + x)*4];
+            std::memcpy(dst + AtlasPadding*4,line,w*4);
+            for( int i = 0 ; i < AtlasPadding ; ++i )
+            {
+                std::memcpy(dst + i*4,line,4);
+                std::memcpy(dst + (AtlasPadding + w + i)*4,line + (w - 1)*4,4);
+            }
+        }
+        page.dirty = true;
+    }
+}
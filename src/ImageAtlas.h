@@ -0,0 +1,180 @@
+#ifndef IMAGEATLAS_H
+#define IMAGEATLAS_H
+
+namespace NanoCanvas
+{
+    class ImageAtlas;
+
+    /**
+     * @brief Lightweight handle of an image packed into an ImageAtlas
+     *
+     * The handle stays valid when the atlas is repacked, it is resolved to the
+     * texture and the region of the image each time it is drawn.
+     * @see Canvas::drawImage(const SubImage&,float,float,float,float,float,float,float,float)
+     * @see Canvas::createPattern(const SubImage&,float,float,float,float,float,float)
+     */
+    struct SubImage
+    {
+        /// The atlas which owns the image
+        ImageAtlas* atlas = nullptr;
+        /// The id of the image in the atlas
+        unsigned id = 0U;
+
+        /// Check is the handle refer to an image of an atlas
+        inline bool valid()const { return atlas && id; }
+    };
+
+    /**
+     * @class ImageAtlas
+     * @brief Packs many small images into a few large textures
+     *
+     * Drawing images from the same texture doesn't need texture switches, so it can be batched.
+     * The images are packed with a skyline bottom-left packer. Removed images leave holes in
+     * the pages, the atlas is repacked once the holes take too much space.
+     * @note The atlas keeps a copy of the pages in memory to update and repack them.
+     */
+    class ImageAtlas
+    {
+    public:
+        /**
+         * @brief Create an empty atlas
+         * @param canvas The canvas who owns the atlas textures
+         * @param pageWidth The width of each texture page
+         * @param pageHeight The height of each texture page
+         * @param imageFlags Creation flags of texture pages
+         * @see Image::ImageFlag
+         */
+        ImageAtlas(Canvas& canvas,int pageWidth = 1024,int pageHeight = 1024,int imageFlags = 0);
+
+        ~ImageAtlas();
+
+        /// Delete copy constructor
+        ImageAtlas(const ImageAtlas&) = delete;
+        /// Disable assignment
+        ImageAtlas& operator=(const ImageAtlas&) = delete;
+
+        /**
+         * @brief Pack an image with RGBA format into the atlas
+         * @param w The width of the image
+         * @param h The height of the image
+         * @param memory The memery block of w*h*4 bytes to copy
+         * @return The handle of the packed image, invalid if the image is larger than a page
+         */
+        SubImage insert(int w,int h,const Memery& memory);
+
+        /**
+         * @brief Remove an image from the atlas
+         * @param image The image to remove, the handle is invalid after removing
+         */
+        void remove(const SubImage& image);
+
+        /// Repack all images to close the holes left by removed images
+        void repack();
+
+        /**
+         * @brief Get the proportion of the packed area wasted by removed images
+         * @return The value in range [0,1]
+         */
+        float fragmentation()const;
+
+        /// The count of texture pages
+        inline size_t pageCount()const { return m_pages.size(); }
+
+        /**
+         * @brief Find where an image is stored, the modified pages are uploaded
+         * @param image The image to find
+         * @param imageID [out] The NanoVG image id of the page
+         * @param bounds [out] The float array of [x,y,width,height] of the image in the page
+         * @return Is the image found
+         */
+        bool locate(const SubImage& image,int& imageID,float* bounds);
+
+        /**
+         * @brief Get the size of an image
+         * @param image The image to get size
+         * @param width  [out] The width of the image , must be left-value
+         * @param height [out] The height of the image , must be left-value
+         */
+        void size(const SubImage& image,int& width,int& height)const;
+
+        /// Get the size of texture pages
+        inline void pageSize(int& width,int& height)const
+        {
+            width = m_pageWidth;
+            height = m_pageHeight;
+        }
+
+        /// Get the creation flags of texture pages
+        inline int imageFlags()const { return m_imageFlags; }
+
+        /**
+         * @brief Get the memory copy of a texture page
+         * @param imageID The NanoVG image id of the page
+         * @return The RGBA pixels of the page, nullptr if no page has the id
+         */
+        const unsigned char* pagePixels(int imageID)const;
+
+    private:
+        /// A segment of the skyline
+        struct SkylineNode
+        {
+            int x;
+            int y;
+            int width;
+        };
+
+        /// A texture page
+        struct Page
+        {
+            /// The NanoVG image id of the page
+            int imageID = 0;
+            /// Is the memory copy modified since the last upload
+            bool dirty = false;
+            /// The memory copy of the texture
+            std::vector<unsigned char> pixels;
+            /// The skyline of packed images
+            std::vector<SkylineNode> skyline;
+        };
+
+        /// A packed image
+        struct Entry
+        {
+            unsigned page;
+            int x;
+            int y;
+            int w;
+            int h;
+            bool alive;
+        };
+
+        /// Append an empty page
+        Page& addPage();
+
+        /// Get the y-coordinate where a rectangle fits on the skyline from a node, -1 if it doesn't fit
+        int fits(const Page& page,size_t node,int w,int h)const;
+
+        /// Find the best place for a padded rectangle in a page
+        bool pack(Page& page,int w,int h,int& x,int& y);
+
+        /// Find a place for a padded rectangle in the existing pages
+        bool place(int w,int h,unsigned& page,int& x,int& y);
+
+        /// Copy RGBA pixels into a padded rectangle of a page and extrude the edges into the padding
+        void blit(Page& page,int x,int y,int w,int h,const unsigned char* src,int stride);
+
+        /// The canvas who owns the textures
+        Canvas * m_canvas;
+        int m_pageWidth;
+        int m_pageHeight;
+        int m_imageFlags;
+        /// Pixels of images wasted by removed images
+        long m_wastedArea = 0;
+        /// Pixels of alive images
+        long m_usedArea = 0;
+        std::vector<Page>  m_pages;
+        /// Entries indexed by id-1, ids are never reused
+        std::vector<Entry> m_entries;
+    };
+}
+
+#endif // IMAGEATLAS_H
@@ -0,0 +1,107 @@
+#include "NanoCanvas.h"
+#include "nanovg.h"
+
+namespace NanoCanvas
+{
+    /// The 64-bit FNV-1a hash of a memory block
+    static unsigned long long fnv1a(const unsigned char* data,unsigned long size)
+    {
+        unsigned long long hash = 14695981039346656037ULL;
+        for( unsigned long i = 0 ; i < size ; ++i )
+        {
+            hash ^= data[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    ImageCache::ImageCache(Canvas& canvas,size_t byteBudget)
+    {
+        m_canvas = &canvas;
+        m_budget = byteBudget;
+    }
+
+    std::shared_ptr<Image> ImageCache::get(const string& filePath,int imageFlags)
+    {
+        string key = "f" + std::to_string(imageFlags) + ":" + filePath;
+        auto image = find(key);
+        if( !image )
+            image = add(key,new Image(*m_canvas,filePath,imageFlags));
+        return image;
+    }
+
+    std::shared_ptr<Image> ImageCache::get(const Memery& memory,int imageFlags)
+    {
+        unsigned long long hash = fnv1a((const unsigned char*)memory.data,memory.data ? memory.size : 0UL);
+        string key = "m" + std::to_string(imageFlags) + ":" + std::to_string(memory.size) +
+                     ":" + std::to_string(hash);
+        auto image = find(key);
+        if( !image )
+            image = add(key,new Image(*m_canvas,memory,imageFlags));
+        return image;
+    }
+
+    void ImageCache::setBudget(size_t byteBudget)
+    {
+        m_budget = byteBudget;
+        trim();
+    }
+
+    void ImageCache::trim()
+    {
+        auto it = m_entries.end();
+        while( m_bytes > m_budget && it != m_entries.begin() )
+        {
+            --it;
+            // Images still drawn by somebody can't be deleted
+            if( it->image.use_count() > 1 )
+                continue;
+            m_bytes -= it->bytes;
+            m_index.erase(it->key);
+            it = m_entries.erase(it);
+        }
+    }
+
+    void ImageCache::clear()
+    {
+        for( auto it = m_entries.begin() ; it != m_entries.end() ; )
+        {
+            if( it->image.use_count() > 1 )
+            {
+                ++it;
+                continue;
+            }
+            m_bytes -= it->bytes;
+            m_index.erase(it->key);
+            it = m_entries.erase(it);
+        }
+    }
+
+    std::shared_ptr<Image> ImageCache::find(const string& key)
+    {
+        auto found = m_index.find(key);
+        if( found == m_index.end() )
+            return nullptr;
+        m_entries.splice(m_entries.begin(),m_entries,found->second);
+        return found->second->image;
+    }
+
+    std::shared_ptr<Image> ImageCache::add(const string& key,Image* image)
+    {
+        std::shared_ptr<Image> shared(image);
+        if( !image->valid() )
+            return shared;
+        int w = 0,h = 0;
+        image->size(w,h);
+
+        Entry entry;
+        entry.key = key;
+        entry.image = shared;
+        entry.bytes = (size_t)w*h*4;
+        m_entries.push_front(entry);
+        m_index[key] = m_entries.begin();
+        m_bytes += entry.bytes;
+        trim();
+        return shared;
+    }
+}
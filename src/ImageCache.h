@@ -0,0 +1,100 @@
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+namespace NanoCanvas
+{
+    /**
+     * @class ImageCache
+     * @brief Shares images loaded from the same file or memory and bounds their memory
+     *
+     * Images are keyed by file path or by the content hash of the memory block, together with
+     * the creation flags. Each decoded image is counted as width*height*4 bytes, once the budget
+     * is exceeded the least recently used images which are not referenced out of the cache are deleted.
+     * @code
+     * ImageCache cache(canvas,64 << 20);
+     * auto icon = cache.get("icon.png");
+     * if( icon->valid() )
+     *     canvas.drawImage(*icon,10,10);
+     * @endcode
+     */
+    class ImageCache
+    {
+    public:
+        /**
+         * @brief Create an empty cache
+         * @param canvas The canvas who owns the cached images
+         * @param byteBudget How many bytes of decoded images can be kept
+         */
+        ImageCache(Canvas& canvas,size_t byteBudget = 256UL << 20);
+
+        /// Delete copy constructor
+        ImageCache(const ImageCache&) = delete;
+        /// Disable assignment
+        ImageCache& operator=(const ImageCache&) = delete;
+
+        /**
+         * @brief Get an image loaded from the disk, it is loaded only if not cached
+         * @param filePath The image file path to load
+         * @param imageFlags Creation flags
+         * @see Image::ImageFlag
+         * @return The shared image, it is invalid if failed to load and not cached
+         */
+        std::shared_ptr<Image> get(const string& filePath,int imageFlags = 0);
+
+        /**
+         * @brief Get an image loaded from a chunk of memory, it is loaded only if not cached
+         * @param memory The memery block to load from
+         * @param imageFlags Creation flags
+         * @see Image::ImageFlag
+         * @return The shared image, it is invalid if failed to load and not cached
+         */
+        std::shared_ptr<Image> get(const Memery& memory,int imageFlags = 0);
+
+        /**
+         * @brief Set the memory budget, the unused images out of budget are deleted
+         * @param byteBudget How many bytes of decoded images can be kept
+         */
+        void setBudget(size_t byteBudget);
+
+        /// Get the memory budget in bytes
+        inline size_t budget()const { return m_budget; }
+
+        /// Get the bytes of decoded images in the cache
+        inline size_t bytes()const { return m_bytes; }
+
+        /// Get the count of images in the cache
+        inline size_t count()const { return m_entries.size(); }
+
+        /// Delete the least recently used images not referenced out of the cache until it fits the budget
+        void trim();
+
+        /// Delete all the images not referenced out of the cache
+        void clear();
+
+    private:
+        /// A cached image
+        struct Entry
+        {
+            string key;
+            std::shared_ptr<Image> image;
+            size_t bytes;
+        };
+
+        /// Find an image and mark it as the most recently used
+        std::shared_ptr<Image> find(const string& key);
+
+        /// Add a loaded image into the cache
+        std::shared_ptr<Image> add(const string& key,Image* image);
+
+        /// The canvas who owns the images
+        Canvas * m_canvas;
+        size_t m_budget;
+        size_t m_bytes = 0;
+        /// Entries from the most recently used to the least
+        std::list<Entry> m_entries;
+        /// Entries indexed by key
+        std::unordered_map<string,std::list<Entry>::iterator> m_index;
+    };
+}
+
+#endif // IMAGECACHE_H
@@ -0,0 +1,182 @@
+#include "NanoCanvas.h"
+#include "nanovg.h"
+#include "stb_image.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace NanoCanvas
+{
+    struct ImageLoader::Queue
+    {
+        /// An image to decode or to upload
+        struct Job
+        {
+            std::shared_ptr<AsyncImage> image;
+            string filePath;
+            std::vector<unsigned char> data;
+            int flags = 0;
+            unsigned char * pixels = nullptr;
+            int width = 0;
+            int height = 0;
+        };
+
+        std::mutex mutex;
+        std::condition_variable wakeup;
+        /// Jobs waiting for decoding
+        std::deque<Job> jobs;
+        /// Jobs waiting for upload
+        std::deque<Job> decoded;
+        /// Jobs being decoded
+        size_t decoding = 0;
+        bool stopping = false;
+        std::vector<std::thread> workers;
+
+        void push(Job&& job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                jobs.push_back(std::move(job));
+            }
+            wakeup.notify_one();
+        }
+
+        void work()
+        {
+            for(;;)
+            {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wakeup.wait(lock,[this]{ return stopping || !jobs.empty(); });
+                    if( stopping )
+                        return;
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                    ++decoding;
+                }
+                // Nobody waits for the image any more
+                if( job.image.use_count() > 1 )
+                    decode(job);
+                std::lock_guard<std::mutex> lock(mutex);
+                --decoding;
+                decoded.push_back(std::move(job));
+            }
+        }
+
+        static void decode(Job& job)
+        {
+            int n = 0;
+            if( job.data.size() )
+            {
+                job.pixels = stbi_load_from_memory(job.data.data(),(int)job.data.size(),
+                                                   &job.width,&job.height,&n,4);
+                std::vector<unsigned char>().swap(job.data);
+            }
+            else
+                job.pixels = stbi_load(job.filePath.c_str(),&job.width,&job.height,&n,4);
+        }
+    };
+
+    ImageLoader::ImageLoader(Canvas& canvas,unsigned threads)
+    {
+        m_canvas = &canvas;
+        m_queue = new Queue;
+        // The same options as nvgCreateImage
+        stbi_set_unpremultiply_on_load(1);
+        stbi_convert_iphone_png_to_rgb(1);
+        if( !threads )
+            threads = std::max(std::thread::hardware_concurrency(),2U) - 1;
+        for( unsigned i = 0 ; i < threads ; ++i )
+            m_queue->workers.push_back(std::thread(&Queue::work,m_queue));
+    }
+
+    ImageLoader::~ImageLoader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_queue->mutex);
+            m_queue->stopping = true;
+        }
+        m_queue->wakeup.notify_all();
+        for( auto& worker : m_queue->workers )
+            worker.join();
+        for( auto& job : m_queue->decoded )
+            if( job.pixels )
+                stbi_image_free(job.pixels);
+        delete m_queue;
+    }
+
+    std::shared_ptr<AsyncImage> ImageLoader::load(const string& filePath,int imageFlags)
+    {
+        auto image = std::make_shared<AsyncImage>();
+        Queue::Job job;
+        job.image = image;
+        job.filePath = filePath;
+        job.flags = imageFlags;
+        m_queue->push(std::move(job));
+        return image;
+    }
+
+    std::shared_ptr<AsyncImage> ImageLoader::load(const Memery& memory,int imageFlags)
+    {
+        auto image = std::make_shared<AsyncImage>();
+        if( !memory.valid() )
+        {
+            image->m_status = AsyncImage::Status::Failed;
+            return image;
+        }
+        Queue::Job job;
+        job.image = image;
+        const unsigned char* data = (const unsigned char*)memory.data;
+        job.data.assign(data,data + memory.size);
+        job.flags = imageFlags;
+        m_queue->push(std::move(job));
+        return image;
+    }
+
+    size_t ImageLoader::upload(size_t byteBudget)
+    {
+        size_t finished = 0;
+        size_t uploaded = 0;
+        while( !finished || uploaded < byteBudget )
+        {
+            Queue::Job job;
+            {
+                std::lock_guard<std::mutex> lock(m_queue->mutex);
+                if( m_queue->decoded.empty() )
+                    break;
+                job = std::move(m_queue->decoded.front());
+                m_queue->decoded.pop_front();
+            }
+            if( job.image.use_count() == 1 )
+            {
+                if( job.pixels )
+                    stbi_image_free(job.pixels);
+                continue;
+            }
+            ++finished;
+            if( !job.pixels )
+            {
+                job.image->m_status = AsyncImage::Status::Failed;
+                continue;
+            }
+            size_t bytes = (size_t)job.width*job.height*4;
+            Memery memory;
+            memory.data = job.pixels;
+            memory.size = bytes;
+            job.image->m_image.reset(new Image(*m_canvas,job.width,job.height,memory,job.flags));
+            stbi_image_free(job.pixels);
+            job.image->m_status = job.image->m_image->valid() ? AsyncImage::Status::Ready
+                                                              : AsyncImage::Status::Failed;
+            uploaded += bytes;
+        }
+        return finished;
+    }
+
+    size_t ImageLoader::pending()const
+    {
+        std::lock_guard<std::mutex> lock(m_queue->mutex);
+        return m_queue->jobs.size() + m_queue->decoding + m_queue->decoded.size();
+    }
+}
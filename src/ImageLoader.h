@@ -0,0 +1,124 @@
+#ifndef IMAGELOADER_H
+#define IMAGELOADER_H
+
+namespace NanoCanvas
+{
+    /**
+     * @class AsyncImage
+     * @brief The handle of an image loading by an ImageLoader
+     *
+     * The handle is pending until the image is decoded and uploaded to the texture.
+     * @note The handle must be used on the render thread only
+     */
+    class AsyncImage
+    {
+    public:
+        /// The loading status of the image
+        enum class Status
+        {
+            /// The image is decoding or waiting for upload
+            Pending,
+            /// The image is uploaded and ready to draw
+            Ready,
+            /// The file can't be read or decoded
+            Failed
+        };
+
+        /// Get the loading status of the image
+        inline Status status()const { return m_status; }
+
+        /// Check is the image ready to draw
+        inline bool ready()const { return m_status == Status::Ready; }
+
+        /**
+         * @brief Get the loaded image
+         * @return The image to draw, nullptr until the image is ready
+         */
+        inline Image* image(){ return m_image.get(); }
+
+    private:
+        friend class ImageLoader;
+
+        Status m_status = Status::Pending;
+        std::unique_ptr<Image> m_image;
+    };
+
+    /**
+     * @class ImageLoader
+     * @brief Decodes images on worker threads and uploads them on the render thread
+     *
+     * Reading and decoding files with Image(Canvas&,const string&,int) stalls the frame.
+     * The loader decodes on a pool of threads, only the texture upload happens in upload(),
+     * which should be called once per frame with a byte budget to keep the frame time flat.
+     * @code
+     * ImageLoader loader(canvas);
+     * auto photo = loader.load("photo.jpg");
+     * // main render loop
+     * canvas.begineFrame(wndWidth,wndHeight);
+     * loader.upload(4 << 20);
+     * if( photo->ready() )
+     *     canvas.drawImage(*photo->image(),0,0);
+     * canvas.endFrame();
+     * @endcode
+     */
+    class ImageLoader
+    {
+    public:
+        /**
+         * @brief Create a loader and start its worker threads
+         * @param canvas The canvas who owns the loaded images
+         * @param threads The count of worker threads, 0 to use one less than the hardware threads
+         */
+        ImageLoader(Canvas& canvas,unsigned threads = 0);
+
+        /// Stop the worker threads, the pending images never become ready
+        ~ImageLoader();
+
+        /// Delete copy constructor
+        ImageLoader(const ImageLoader&) = delete;
+        /// Disable assignment
+        ImageLoader& operator=(const ImageLoader&) = delete;
+
+        /**
+         * @brief Load an image file asynchronously
+         * @param filePath The image file path to load
+         * @param imageFlags Creation flags
+         * @see Image::ImageFlag
+         * @return The handle of the loading image
+         */
+        std::shared_ptr<AsyncImage> load(const string& filePath,int imageFlags = 0);
+
+        /**
+         * @brief Load an image from a chunk of memory asynchronously
+         * @param memory The memery block to load from, it is copied so it can be freed after calling
+         * @param imageFlags Creation flags
+         * @see Image::ImageFlag
+         * @return The handle of the loading image
+         */
+        std::shared_ptr<AsyncImage> load(const Memery& memory,int imageFlags = 0);
+
+        /**
+         * @brief Upload the decoded images to textures, must be called on the render thread
+         *
+         * At least one decoded image is uploaded on each call, so images larger than the budget are loaded too.
+         *
+         * @param byteBudget How many bytes of decoded pixels can be uploaded in this call
+         * @return The count of images finished loading in this call
+         */
+        size_t upload(size_t byteBudget);
+
+        /// The count of images not finished loading
+        size_t pending()const;
+
+    private:
+        /// The job queues shared with the worker threads
+        struct Queue;
+
+        /// The canvas who owns the loaded images
+        Canvas * m_canvas = nullptr;
+        /// The job queues of this loader
+        Queue * m_queue = nullptr;
+    };
+}
+
+#endif // IMAGELOADER_H
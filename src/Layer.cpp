@@ -0,0 +1,24 @@
+#include "NanoCanvas.h"
+#include "nanovg.h"
+
+namespace NanoCanvas
+{
+    Layer::Layer(Canvas& ,int width,int height)
+    {
+        m_width = std::max(width,1);
+        m_height = std::max(height,1);
+    }
+
+    void Layer::resize(int width,int height)
+    {
+        width = std::max(width,1);
+        height = std::max(height,1);
+        if( width != m_width || height != m_height )
+        {
+            m_width = width;
+            m_height = height;
+            m_image.reset();
+        }
+        m_dirty = true;
+    }
+}
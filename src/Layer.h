@@ -0,0 +1,96 @@
+#ifndef LAYER_H
+#define LAYER_H
+
+namespace NanoCanvas
+{
+    /**
+     * @class Layer
+     * @brief Drawing rendered offscreen once and composited as an image until invalidated
+     *
+     * The content of a layer is rasterized by a SoftwareRenderer, so layers work with any backend.
+     * @code
+     * Layer grid(canvas,800,600);
+     * // main render loop
+     * if( canvas.beginLayer(grid) )
+     * {
+     *     // Draw the chart grid, only when the layer is invalidated
+     *     canvas.endLayer();
+     * }
+     * canvas.drawLayer(grid,0,0);
+     * @endcode
+     * The layer is rasterized at the scale ratio of the canvas, so it stays sharp on Hi-DPI screens.
+     * @note Fonts of the canvas can be used in layers, fonts loaded from memory must stay alive
+     * as long as the canvas. Images loaded from files and images packed in atlases are copied into
+     * the offscreen context while the layer is drawn. Other images, and patterns of images not drawn
+     * in the layer before, are skipped and counted by missingImages(). Layers can't be nested.
+     * @see Canvas::beginLayer
+     */
+    class Layer
+    {
+    public:
+        /**
+         * @brief Create an empty layer
+         * @param canvas The canvas who owns the layer image
+         * @param width The width of the layer, in canvas units
+         * @param height The height of the layer, in canvas units
+         */
+        Layer(Canvas& canvas,int width,int height);
+
+        /// Delete copy constructor
+        Layer(const Layer&) = delete;
+        /// Disable assignment
+        Layer& operator=(const Layer&) = delete;
+
+        /// Mark the content to be drawn again by the next Canvas::beginLayer
+        inline void invalidate(){ m_dirty = true; }
+
+        /// Check is the content waiting to be drawn
+        inline bool dirty()const { return m_dirty || !m_image; }
+
+        /**
+         * @brief Resize the layer, the content is invalidated
+         * @param width The width of the layer, in canvas units
+         * @param height The height of the layer, in canvas units
+         */
+        void resize(int width,int height);
+
+        /// The width of the layer
+        inline int width()const { return m_width; }
+
+        /// The height of the layer
+        inline int height()const { return m_height; }
+
+        /**
+         * @brief Get the image of the content with premultiplied alpha
+         * 
+         * The image has the size of the layer multiplied by the scale ratio of the canvas.
+         * @return The image to draw the layer, nullptr until the layer is drawn
+         * @see Canvas::drawLayer
+         */
+        inline Image* image(){ return m_image.get(); }
+        
+        /// The count of image draws skipped the last time the layer was drawn
+        inline size_t missingImages()const { return m_missingImages; }
+
+    private:
+        friend class Canvas;
+
+        int m_width;
+        int m_height;
+        bool m_dirty = true;
+        /// The offscreen renderer
+        std::unique_ptr<SoftwareRenderer> m_renderer;
+        /// The count of canvas fonts created in the offscreen context
+        size_t m_fonts = 0;
+        /// The gradient textures of the offscreen context
+        Canvas::GradientCache m_gradientImages;
+        /// The content uploaded to the canvas
+        std::unique_ptr<Image> m_image;
+        /// The copies of canvas images in the offscreen context while drawing, keyed by canvas image id
+        std::unordered_map<int,int> m_images;
+        /// The count of image draws skipped while drawing
+        size_t m_missingImages = 0;
+    };
+}
+
+#endif // LAYER_H
@@ -0,0 +1,69 @@
+#include "NanoCanvas.h"
+#include "nanovg.h"
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace NanoCanvas
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const string& filePath)
+    {
+        HANDLE file = CreateFileA(filePath.c_str(),GENERIC_READ,FILE_SHARE_READ,nullptr,
+                                  OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+        if( file == INVALID_HANDLE_VALUE )
+            return;
+        LARGE_INTEGER size;
+        if( GetFileSizeEx(file,&size) && size.QuadPart > 0 )
+        {
+            HANDLE mapping = CreateFileMappingA(file,nullptr,PAGE_READONLY,0,0,nullptr);
+            if( mapping )
+            {
+                // The view keeps the mapping alive after closing the handles
+                m_memory.data = MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+                if( m_memory.data )
+                    m_memory.size = (unsigned long)size.QuadPart;
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if( m_memory.data )
+            UnmapViewOfFile(m_memory.data);
+    }
+#else
+    MappedFile::MappedFile(const string& filePath)
+    {
+        int fd = open(filePath.c_str(),O_RDONLY);
+        if( fd < 0 )
+            return;
+        struct stat st;
+        if( fstat(fd,&st) == 0 && st.st_size > 0 )
+        {
+            // The mapping keeps the file alive after closing the descriptor
+            void* data = mmap(nullptr,st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+            if( data != MAP_FAILED )
+            {
+                m_memory.data = data;
+                m_memory.size = (unsigned long)st.st_size;
+            }
+        }
+        close(fd);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if( m_memory.data )
+            munmap(m_memory.data,m_memory.size);
+    }
+#endif
+}
@@ -0,0 +1,52 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+namespace NanoCanvas
+{
+    /**
+     * @class MappedFile
+     * @brief A file mapped read-only into memory
+     *
+     * The pages of the file are loaded by the system on access and shared with the file cache,
+     * so loading large fonts and images from a mapping doesn't copy them into the heap.
+     * @code
+     * auto ttf = std::make_shared<MappedFile>("NotoSansCJK.ttf");
+     * Font cjk(canvas,"cjk",ttf);                    // The canvas keeps the mapping alive
+     * MappedFile png("photo.png");
+     * Image photo(canvas,png.memory());              // The mapping can be closed after decoding
+     * @endcode
+     */
+    class MappedFile
+    {
+    public:
+        /**
+         * @brief Map a file into memory
+         * @param filePath The path of the file to map
+         */
+        explicit MappedFile(const string& filePath);
+
+        /// Unmap the file, the memory is invalid after that
+        ~MappedFile();
+
+        /// Delete copy constructor
+        MappedFile(const MappedFile&) = delete;
+        /// Disable assignment
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /// Check is the file mapped
+        inline bool valid()const { return m_memory.valid(); }
+
+        /**
+         * @brief Get the mapped memory
+         * @attention The memory is read-only, writing to it crashes
+         * @return The memery block of the file content
+         */
+        inline const Memery& memory()const { return m_memory; }
+
+    private:
+        /// The mapped memory
+        Memery m_memory;
+    };
+}
+
+#endif // MAPPEDFILE_H
@@ -2,9 +2,17 @@
 #define __NANOCANVAS_H__
 
 #include <climits>
+#include <cfloat>
 #include <algorithm>
 #include <string>
+#include <vector>
+#include <memory>
+#include <list>
+#include <unordered_map>
 #include <cmath>
+#ifdef NANOCANVAS_FRAME_STATS
+    #include <chrono>
+#endif
 
 
 namespace NanoCanvas
@@ -67,6 +75,16 @@ namespace NanoCanvas
 #include "Text.h"
 #include "Image.h"
 #include "Paint.hpp"
+#include "FrameArena.h"
+#include "HitGrid.h"
 #include "Canvas.h"
+#include "DisplayList.h"
+#include "Path2D.h"
+#include "ImageAtlas.h"
+#include "ImageLoader.h"
+#include "ImageCache.h"
+#include "MappedFile.h"
+#include "SoftwareRenderer.h"
+#include "Layer.h"
 
 #endif //__NANOCANVAS_H__
@@ -3,6 +3,15 @@
 
 namespace NanoCanvas
 {
+    /// A color at a position of a gradient
+    struct ColorStop
+    {
+        /// The position of the color between the start and the end of the gradient, in range [0,1]
+        float offset;
+        /// The color at the position
+        Color color;
+    };
+    
     /// The Paint can be used as gradiants and image patterns with Canvas::fillStyle
     /// @see Canvas::fillStyle 
     struct Paint
@@ -28,6 +37,68 @@ namespace NanoCanvas
         Color sColor = Colors::ZeroColor;
         /// The end color of the gradiant
         Color eColor = Colors::ZeroColor;
+        /// The color stops of linear and radial gradiants, used instead of sColor and eColor if not empty
+        std::vector<ColorStop> stops;
+        
+        /**
+         * @brief Add a color stop to a linear or radial gradiant
+         * 
+         * Stops at the same offset are kept in the order they are added, which makes hard color edges.
+         * @note Box gradiants ignore color stops
+         * @param offset The position of the color between the start and the end, in range [0,1]
+         * @param color The color at the position
+         * @return The paint to add more color stops
+         */
+        inline Paint& addColorStop(float offset,const Color& color)
+        {
+            ColorStop stop;
+            stop.offset = clamp(offset,0.0f,1.0f);
+            stop.color = color;
+            auto pos = std::upper_bound(stops.begin(),stops.end(),stop,
+                                        [](const ColorStop& a,const ColorStop& b){ return a.offset < b.offset; });
+            stops.insert(pos,stop);
+            return *this;
+        }
+    };
+    
+    class Canvas;
+    
+    /**
+     * @brief A Paint resolved into the form used by the renderer
+     * 
+     * Converting a Paint for NanoVG happens each time it is used with Canvas::fillStyle.
+     * A compiled paint is converted once by Canvas::compilePaint and reused,
+     * it is converted again automatically only when the canvas is moved by Canvas::setPosition.
+     * @see Canvas::fillStyle(const CompiledPaint&)
+     */
+    class CompiledPaint
+    {
+    public:
+        CompiledPaint() = default;
+        
+        /// Get the paint compiled from
+        inline const Paint& source()const { return m_source; }
+        
+        /// Check is the paint can be used
+        inline bool valid()const { return m_source.type != Paint::Type::None; }
+        
+    private:
+        friend class Canvas;
+        
+        /// The paint compiled from
+        Paint m_source;
+        /// The canvas compiled for
+        mutable const Canvas * m_canvas = nullptr;
+        /// The position epoch of the canvas compiled for
+        mutable unsigned long m_epoch = 0UL;
+        /// The resolved NanoVG paint fields
+        mutable float m_xform[6];
+        mutable float m_extent[2];
+        mutable float m_radius = 0.0f;
+        mutable float m_feather = 0.0f;
+        mutable float m_innerColor[4];
+        mutable float m_outerColor[4];
+        mutable int m_image = 0;
     };
 }
 
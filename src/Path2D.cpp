@@ -0,0 +1,387 @@
+#include "NanoCanvas.h"
+#include "nanovg.h"
+
+namespace NanoCanvas
+{
+    namespace
+    {
+        /// Kappa constant to approximate a quarter of circle with a cubic Bézier curve
+        constexpr float KAPPA90 = 0.5522847493f;
+    }
+
+    Path2D::Path2D(float tolerance)
+    {
+        m_tolerance = tolerance > 0.0f ? tolerance : 0.25f;
+        clear();
+    }
+
+    void Path2D::clear()
+    {
+        m_points.clear();
+        m_subPaths.clear();
+        m_bounds[0] = m_bounds[1] = FLT_MAX;
+        m_bounds[2] = m_bounds[3] = -FLT_MAX;
+    }
+
+    void Path2D::addPoint(float x,float y)
+    {
+        if( m_subPaths.empty() )
+        {
+            moveTo(x,y);
+            return;
+        }
+        if( m_subPaths.back().closed )
+        {
+            // Start a new sub path at the start point of the closed one
+            const SubPath& last = m_subPaths.back();
+            float sx = m_points[last.first*2];
+            float sy = m_points[last.first*2+1];
+            moveTo(sx,sy);
+        }
+        m_points.push_back(x);
+        m_points.push_back(y);
+        m_subPaths.back().count++;
+        m_bounds[0] = std::min(m_bounds[0],x);
+        m_bounds[1] = std::min(m_bounds[1],y);
+        m_bounds[2] = std::max(m_bounds[2],x);
+        m_bounds[3] = std::max(m_bounds[3],y);
+    }
+
+    void Path2D::flattenBezier(float x1,float y1,float x2,float y2,
+                               float x3,float y3,float x4,float y4,int level)
+    {
+        if( level > 10 )
+            return;
+
+        float x12 = (x1+x2)*0.5f;
+        float y12 = (y1+y2)*0.5f;
+        float x23 = (x2+x3)*0.5f;
+        float y23 = (y2+y3)*0.5f;
+        float x34 = (x3+x4)*0.5f;
+        float y34 = (y3+y4)*0.5f;
+        float x123 = (x12+x23)*0.5f;
+        float y123 = (y12+y23)*0.5f;
+
+        float dx = x4 - x1;
+        float dy = y4 - y1;
+        float d2 = std::fabs(((x2 - x4) * dy - (y2 - y4) * dx));
+        float d3 = std::fabs(((x3 - x4) * dy - (y3 - y4) * dx));
+
+        if( (d2 + d3)*(d2 + d3) < m_tolerance * (dx*dx + dy*dy) )
+        {
+            addPoint(x4,y4);
+            return;
+        }
+
+        float x234 = (x23+x34)*0.5f;
+        float y234 = (y23+y34)*0.5f;
+        float x1234 = (x123+x234)*0.5f;
+        float y1234 = (y123+y234)*0.5f;
+
+        flattenBezier(x1,y1, x12,y12, x123,y123, x1234,y1234, level+1);
+        flattenBezier(x1234,y1234, x234,y234, x34,y34, x4,y4, level+1);
+    }
+
+/* ------------------- Basic Path ----------------------*/
+
+    Path2D& Path2D::moveTo(float x,float y)
+    {
+        SubPath sub;
+        sub.first = (unsigned)m_points.size()/2;
+        sub.count = 0;
+        sub.closed = false;
+        sub.winding = Canvas::Winding::CCW;
+        m_subPaths.push_back(sub);
+        addPoint(x,y);
+        return *this;
+    }
+
+    Path2D& Path2D::lineTo(float x,float y)
+    {
+        addPoint(x,y);
+        return *this;
+    }
+
+    Path2D& Path2D::arcTo(float x1,float y1,float x2,float y2,float r)
+    {
+        if( m_subPaths.empty() )
+            return moveTo(x1,y1);
+
+        float x0 = m_points[m_points.size()-2];
+        float y0 = m_points[m_points.size()-1];
+        float dx0 = x0-x1;
+        float dy0 = y0-y1;
+        float dx1 = x2-x1;
+        float dy1 = y2-y1;
+        float l0 = std::sqrt(dx0*dx0 + dy0*dy0);
+        float l1 = std::sqrt(dx1*dx1 + dy1*dy1);
+        if( l0 < 1e-6f || l1 < 1e-6f || r < 1e-6f )
+            return lineTo(x1,y1);
+        dx0 /= l0; dy0 /= l0;
+        dx1 /= l1; dy1 /= l1;
+
+        float a = std::acos(clamp(dx0*dx1 + dy0*dy1,-1.0f,1.0f));
+        float d = r / std::tan(a/2.0f);
+        if( !(d < 10000.0f) )
+            return lineTo(x1,y1);
+
+        float cx,cy,a0,a1;
+        bool counterclockwise;
+        if( dx1*dy0 - dx0*dy1 > 0.0f )
+        {
+            cx = x1 + dx0*d + dy0*r;
+            cy = y1 + dy0*d + -dx0*r;
+            a0 = std::atan2(dx0, -dy0);
+            a1 = std::atan2(-dx1, dy1);
+            counterclockwise = false;
+        }
+        else
+        {
+            cx = x1 + dx0*d + -dy0*r;
+            cy = y1 + dy0*d + dx0*r;
+            a0 = std::atan2(-dx0, dy0);
+            a1 = std::atan2(dx1, -dy1);
+            counterclockwise = true;
+        }
+        return arc(cx,cy,r,a0,a1,counterclockwise);
+    }
+
+    Path2D& Path2D::quadraticCurveTo(float cpx,float cpy,float x, float y)
+    {
+        if( m_subPaths.empty() )
+            moveTo(cpx,cpy);
+        float x0 = m_points[m_points.size()-2];
+        float y0 = m_points[m_points.size()-1];
+        return bezierCurveTo(x0 + 2.0f/3.0f*(cpx - x0), y0 + 2.0f/3.0f*(cpy - y0),
+                             x + 2.0f/3.0f*(cpx - x), y + 2.0f/3.0f*(cpy - y),
+                             x, y);
+    }
+
+    Path2D& Path2D::bezierCurveTo(float cp1x,float cp1y,
+                                  float cp2x,float cp2y,
+                                  float x, float y)
+    {
+        if( m_subPaths.empty() )
+            moveTo(cp1x,cp1y);
+        float x0 = m_points[m_points.size()-2];
+        float y0 = m_points[m_points.size()-1];
+        flattenBezier(x0,y0,cp1x,cp1y,cp2x,cp2y,x,y,0);
+        return *this;
+    }
+
+    Path2D& Path2D::arc(float x,float y,float r,
+                        float sAngle,float eAngle,bool counterclockwise)
+    {
+        const float PI2 = (float)(PI*2);
+        float da = eAngle - sAngle;
+        if( counterclockwise )
+        {
+            if( std::fabs(da) >= PI2 )
+                da = -PI2;
+            else
+                while( da > 0.0f ) da -= PI2;
+        }
+        else
+        {
+            if( std::fabs(da) >= PI2 )
+                da = PI2;
+            else
+                while( da < 0.0f ) da += PI2;
+        }
+
+        // The angle step which keeps the chord within tolerance
+        float step = PI2;
+        if( r > m_tolerance )
+            step = 2.0f * std::acos(1.0f - m_tolerance / r);
+        int segments = clamp((int)std::ceil(std::fabs(da) / step),1,1024);
+
+        for( int i = 0 ; i <= segments ; ++i )
+        {
+            float a = sAngle + da * i / segments;
+            float px = x + std::cos(a) * r;
+            float py = y + std::sin(a) * r;
+            if( i == 0 && m_subPaths.empty() )
+                moveTo(px,py);
+            else
+                lineTo(px,py);
+        }
+        return *this;
+    }
+
+    Path2D& Path2D::closePath()
+    {
+        if( m_subPaths.size() )
+            m_subPaths.back().closed = true;
+        return *this;
+    }
+
+/* ------------------- Advance Path --------------------*/
+
+    Path2D& Path2D::rect(float x,float y,float w,float h)
+    {
+        moveTo(x,y);
+        lineTo(x,y+h);
+        lineTo(x+w,y+h);
+        lineTo(x+w,y);
+        return closePath();
+    }
+
+    Path2D& Path2D::roundedRect(float x,float y,float w,float h,float r)
+    {
+        if( r < 0.1f )
+            return rect(x,y,w,h);
+
+        float rx = std::min(r, std::fabs(w)*0.5f) * (w < 0 ? -1.0f : 1.0f);
+        float ry = std::min(r, std::fabs(h)*0.5f) * (h < 0 ? -1.0f : 1.0f);
+        float k = 1.0f - KAPPA90;
+        moveTo(x, y+ry);
+        lineTo(x, y+h-ry);
+        bezierCurveTo(x, y+h-ry*k, x+rx*k, y+h, x+rx, y+h);
+        lineTo(x+w-rx, y+h);
+        bezierCurveTo(x+w-rx*k, y+h, x+w, y+h-ry*k, x+w, y+h-ry);
+        lineTo(x+w, y+ry);
+        bezierCurveTo(x+w, y+ry*k, x+w-rx*k, y, x+w-rx, y);
+        lineTo(x+rx, y);
+        bezierCurveTo(x+rx*k, y, x, y+ry*k, x, y+ry);
+        return closePath();
+    }
+
+    Path2D& Path2D::circle(float cx ,float cy , float r)
+    {
+        return ellipse(cx,cy,r,r);
+    }
+
+    Path2D& Path2D::ellipse(float cx, float cy, float rx, float ry)
+    {
+        moveTo(cx-rx, cy);
+        bezierCurveTo(cx-rx, cy+ry*KAPPA90, cx-rx*KAPPA90, cy+ry, cx, cy+ry);
+        bezierCurveTo(cx+rx*KAPPA90, cy+ry, cx+rx, cy+ry*KAPPA90, cx+rx, cy);
+        bezierCurveTo(cx+rx, cy-ry*KAPPA90, cx+rx*KAPPA90, cy-ry, cx, cy-ry);
+        bezierCurveTo(cx-rx*KAPPA90, cy-ry, cx-rx, cy-ry*KAPPA90, cx-rx, cy);
+        return closePath();
+    }
+
+    Path2D& Path2D::pathWinding( Canvas::Winding dir)
+    {
+        if( m_subPaths.size() )
+            m_subPaths.back().winding = dir;
+        return *this;
+    }
+
+/* ------------------- Hit Testing ---------------------*/
+
+    bool Path2D::contains(float x,float y)const
+    {
+        if( x < m_bounds[0] || y < m_bounds[1] || x > m_bounds[2] || y > m_bounds[3] )
+            return false;
+        int winding = 0;
+        for( const SubPath& sub : m_subPaths )
+        {
+            if( sub.count < 3 )
+                continue;
+            // Sub paths are filled closed, the last point connects to the first one
+            const float* p = m_points.data() + sub.first*2;
+            int crossings = 0;
+            float area = 0.0f;
+            for( unsigned i = 0 , j = sub.count - 1 ; i < sub.count ; j = i++ )
+            {
+                float x0 = p[j*2], y0 = p[j*2+1];
+                float x1 = p[i*2], y1 = p[i*2+1];
+                area += x0*y1 - x1*y0;
+                float side = (x1 - x0)*(y - y0) - (x - x0)*(y1 - y0);
+                if( y0 <= y && y1 > y && side > 0.0f )
+                    ++crossings;
+                else if( y1 <= y && y0 > y && side < 0.0f )
+                    --crossings;
+            }
+            // NanoVG reverses the sub paths whose direction doesn't match their winding
+            bool solid = sub.winding == Canvas::Winding::CCW;
+            if( area != 0.0f && ( area > 0.0f ) != solid )
+                crossings = -crossings;
+            winding += crossings;
+        }
+        return winding != 0;
+    }
+
+    bool Path2D::strokeContains(float x,float y,float lineWidth)const
+    {
+        float hw = lineWidth*0.5f;
+        if( x < m_bounds[0] - hw || y < m_bounds[1] - hw || x > m_bounds[2] + hw || y > m_bounds[3] + hw )
+            return false;
+        float hw2 = hw*hw;
+        for( const SubPath& sub : m_subPaths )
+        {
+            const float* p = m_points.data() + sub.first*2;
+            unsigned segments = sub.closed ? sub.count : sub.count - 1;
+            for( unsigned i = 0 ; i < segments && sub.count > 1 ; ++i )
+            {
+                unsigned j = ( i + 1 ) % sub.count;
+                float x0 = p[i*2], y0 = p[i*2+1];
+                float dx = p[j*2] - x0, dy = p[j*2+1] - y0;
+                float length2 = dx*dx + dy*dy;
+                float t = length2 > 0.0f ? clamp(( (x - x0)*dx + (y - y0)*dy ) / length2,0.0f,1.0f) : 0.0f;
+                float ex = x0 + dx*t - x, ey = y0 + dy*t - y;
+                if( ex*ex + ey*ey <= hw2 )
+                    return true;
+            }
+        }
+        return false;
+    }
+
+/* ------------------- Draw Action ---------------------*/
+
+    void Canvas::addPath(const Path2D& path)
+    {
+        NANOCANVAS_STAT(paths,1);
+        nvgBeginPath(m_nvgCtx);
+        resetPath();
+        if( !path.empty() )
+            m_path.add(path.m_bounds[0],path.m_bounds[1],path.m_bounds[2],path.m_bounds[3]);
+        if( Path2D* recorded = recordedPath() )
+            *recorded = path;
+        const float* pts = path.m_points.data();
+        for( const Path2D::SubPath& sub : path.m_subPaths )
+        {
+            const float* p = pts + sub.first*2;
+            for( unsigned i = 0 ; i < sub.count ; ++i , p+=2 )
+            {
+                float x = p[0];
+                float y = p[1];
+                local2Global(x,y);
+                if( i == 0 )
+                    nvgMoveTo(m_nvgCtx,x,y);
+                else
+                    nvgLineTo(m_nvgCtx,x,y);
+            }
+            if( sub.closed )
+                nvgClosePath(m_nvgCtx);
+            if( sub.winding == Winding::CW )
+                nvgPathWinding(m_nvgCtx,NVG_CW);
+        }
+    }
+
+    Canvas& Canvas::fill(const Path2D& path)
+    {
+        NANOCANVAS_TIMER;
+        // The path replaces the current one even if nothing is drawn
+        addPath(path);
+        if( path.empty() || pathRejected(0.0f) )
+            return *this;
+        addPathHit(0.0f);
+        NANOCANVAS_STAT(fills,1);
+        nvgFill(m_nvgCtx);
+        return *this;
+    }
+
+    Canvas& Canvas::stroke(const Path2D& path)
+    {
+        NANOCANVAS_TIMER;
+        addPath(path);
+        if( path.empty() || pathRejected(strokeReach()) )
+            return *this;
+        addPathHit(strokeReach());
+        NANOCANVAS_STAT(strokes,1);
+        nvgStroke(m_nvgCtx);
+        return *this;
+    }
+}
@@ -0,0 +1,137 @@
+#ifndef PATH2D_H
+#define PATH2D_H
+
+namespace NanoCanvas
+{
+    /**
+     * @class Path2D
+     * @brief A reusable path with cached flattened geometry
+     *
+     * The Path2D has the same path building API as the Canvas. Curves and arcs are flattened
+     * into polylines once when they are added, so a path which never changes can be
+     * filled or stroked each frame without flattening the curves again.
+     *
+     * @see Canvas::fill(const Path2D&)
+     * @see Canvas::stroke(const Path2D&)
+     */
+    class Path2D
+    {
+    public:
+        /**
+         * @brief Construct an empty path
+         * @param tolerance The max distance in path units between the flattened polyline and the curve
+         * @note The curves are flattened once in path units, whatever transform the path is drawn with.
+         * A path drawn scaled by s deviates up to tolerance*s pixels from the curve, so pick the
+         * tolerance for the largest scale the path is drawn at, e.g. 0.25f / s for a quarter pixel.
+         */
+        explicit Path2D(float tolerance = 0.25f);
+
+    /* ------------------- Basic Path ----------------------*/
+
+        /// @see Canvas::moveTo
+        Path2D& moveTo(float x,float y);
+
+        /// @see Canvas::lineTo
+        Path2D& lineTo(float x,float y);
+
+        /// @see Canvas::arcTo
+        Path2D& arcTo(float x1,float y1,float x2,float y2,float r);
+
+        /// @see Canvas::quadraticCurveTo
+        Path2D& quadraticCurveTo(float cpx,float cpy,float x, float y);
+
+        /// @see Canvas::bezierCurveTo
+        Path2D& bezierCurveTo(float cp1x,float cp1y,
+                              float cp2x,float cp2y,
+                              float x, float y);
+
+        /// @see Canvas::arc
+        Path2D& arc(float x,float y,float r,
+                    float sAngle,float eAngle,bool counterclockwise = false);
+
+        /// @see Canvas::closePath
+        Path2D& closePath();
+
+    /* ------------------- Advance Path --------------------*/
+
+        /// @see Canvas::rect
+        Path2D& rect(float x,float y,float w,float h);
+
+        /// @see Canvas::roundedRect
+        Path2D& roundedRect(float x,float y,float w,float h,float r);
+
+        /// @see Canvas::circle
+        Path2D& circle(float cx ,float cy , float r);
+
+        /// @see Canvas::ellipse
+        Path2D& ellipse(float cx, float cy, float rx, float ry);
+
+        /// Sets the winding of the last sub path
+        /// @see Canvas::pathWinding
+        Path2D& pathWinding( Canvas::Winding dir);
+
+    /*--------------------- Path propoties -----------------*/
+
+        /// Remove all the sub paths
+        void clear();
+
+        /// Check is there no point in the path
+        inline bool empty()const { return m_points.empty(); }
+
+        /**
+         * @brief Get the bounding box of the flattened path
+         * @return The float array of [minx,miny,maxx,maxy]
+         */
+        inline const float* bounds()const { return m_bounds; }
+
+        /**
+         * @brief Check is a point inside the filled area of the path
+         * 
+         * The sub paths are oriented by their winding like NanoVG does, then filled with the nonzero rule.
+         * @see Canvas::isPointInPath
+         */
+        bool contains(float x,float y)const;
+
+        /**
+         * @brief Check is a point on the stroke of the path
+         * @param lineWidth The width of the stroke
+         * @note Joins and caps are tested as round ones
+         * @see Canvas::isPointInStroke
+         */
+        bool strokeContains(float x,float y,float lineWidth)const;
+
+    private:
+        friend class Canvas;
+
+        /// A flattened sub path
+        struct SubPath
+        {
+            /// Index of the first point
+            unsigned first;
+            /// Count of the points
+            unsigned count;
+            /// Is the sub path closed
+            bool closed;
+            /// The winding of the sub path
+            Canvas::Winding winding;
+        };
+
+        /// Add a point to the last sub path
+        void addPoint(float x,float y);
+
+        /// Flatten a cubic Bézier curve recursively
+        void flattenBezier(float x1,float y1,float x2,float y2,
+                           float x3,float y3,float x4,float y4,int level);
+
+        /// The flattened points as x,y pairs
+        std::vector<float>   m_points;
+        /// The sub paths
+        std::vector<SubPath> m_subPaths;
+        /// The bounding box of the path
+        float m_bounds[4];
+        /// The flattening tolerance in path units
+        float m_tolerance;
+    };
+}
+
+#endif // PATH2D_H
@@ -0,0 +1,1116 @@
+// Solid runs are shaded by SIMD and scalar code that must give the same bytes,
+// so multiplies and adds are not fused into FMA or reassociated
+#if defined(__clang__)
+    #pragma STDC FP_CONTRACT OFF
+    #pragma float_control(precise,on)
+#elif defined(__GNUC__)
+    #pragma GCC optimize("fp-contract=off","no-fast-math")
+#elif defined(_MSC_VER)
+    #pragma fp_contract(off)
+    #pragma float_control(precise,on)
+#endif
+#include "NanoCanvas.h"
+#include "nanovg.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define NANOCANVAS_SSE2 1
+    #include <emmintrin.h>
+#endif
+
+namespace NanoCanvas
+{
+    namespace
+    {
+        /// A texture created by NanoVG
+        struct Texture
+        {
+            int width  = 0;
+            int height = 0;
+            /// NVG_TEXTURE_ALPHA or NVG_TEXTURE_RGBA
+            int type   = 0;
+            /// NanoVG image flags
+            int flags  = 0;
+            /// Is the texture slot in use
+            bool used  = false;
+            /// The texels, one byte per pixel for alpha textures
+            std::vector<unsigned char> data;
+        };
+
+        enum class CallType { Fill, Stroke, Triangles };
+
+        /// A path of a recorded call, the offsets are in the vertex buffer of the backend
+        struct CallPath
+        {
+            int fillOffset;
+            int fillCount;
+            int strokeOffset;
+            int strokeCount;
+        };
+
+        /// A render call recorded until the frame is flushed
+        struct Call
+        {
+            CallType type;
+            NVGpaint paint;
+            NVGcompositeOperationState op;
+            NVGscissor scissor;
+            float fringe;
+            int pathOffset;
+            int pathCount;
+            int vertexOffset;
+            int vertexCount;
+        };
+
+        /// The paint and scissor of a call prepared for shading pixels in view space
+        struct Shader
+        {
+            float paintMat[6];
+            float scissorMat[6];
+            float extent[2];
+            float radius;
+            float feather;
+            float scissorExt[2];
+            float scissorScale[2];
+            /// The device pixel columns the scissor leaves unmasked, when it is axis-aligned
+            int scissorX0;
+            int scissorX1;
+            /// Premultiplied inner color in range [0,1]
+            float inner[4];
+            /// Premultiplied outer color in range [0,1]
+            float outer[4];
+            const Texture* texture;
+            bool solid;
+            bool scissor;
+            /// Is the scissor an axis-aligned rectangle
+            bool scissorAligned;
+        };
+
+        /// Affine mapping from view space to texture coordinates
+        struct UVMap
+        {
+            float u[3];
+            float v[3];
+        };
+
+        inline void transformPoint(const float* t,float x,float y,float& ox,float& oy)
+        {
+            ox = x*t[0] + y*t[2] + t[4];
+            oy = x*t[1] + y*t[3] + t[5];
+        }
+
+        void inverseTransform(float* inv,const float* t)
+        {
+            double det = (double)t[0] * t[3] - (double)t[2] * t[1];
+            if( det > -1e-6 && det < 1e-6 )
+            {
+                inv[0] = inv[3] = 1.0f;
+                inv[1] = inv[2] = inv[4] = inv[5] = 0.0f;
+                return;
+            }
+            double invdet = 1.0 / det;
+            inv[0] = (float)(t[3] * invdet);
+            inv[2] = (float)(-t[2] * invdet);
+            inv[4] = (float)(((double)t[2] * t[5] - (double)t[3] * t[4]) * invdet);
+            inv[1] = (float)(-t[1] * invdet);
+            inv[3] = (float)(t[0] * invdet);
+            inv[5] = (float)(((double)t[1] * t[4] - (double)t[0] * t[5]) * invdet);
+        }
+
+        inline void premultiply(const NVGcolor& c,float* out)
+        {
+            out[0] = c.r * c.a;
+            out[1] = c.g * c.a;
+            out[2] = c.b * c.a;
+            out[3] = c.a;
+        }
+
+        /// Signed distance to a rounded rectangle centered at origin
+        inline float sdroundrect(float px,float py,float ex,float ey,float rad)
+        {
+            float dx = std::fabs(px) - (ex - rad);
+            float dy = std::fabs(py) - (ey - rad);
+            float mx = std::max(dx,0.0f);
+            float my = std::max(dy,0.0f);
+            return std::min(std::max(dx,dy),0.0f) + std::sqrt(mx*mx + my*my) - rad;
+        }
+
+        /// Fetch a texel as RGBA in range [0,1], the same as a GPU would read it
+        inline void fetch(const Texture& tex,int x,int y,float* out)
+        {
+            if( tex.flags & NVG_IMAGE_REPEATX )
+            {
+                x %= tex.width;
+                if( x < 0 ) x += tex.width;
+            }
+            else
+                x = clamp(x,0,tex.width-1);
+            if( tex.flags & NVG_IMAGE_REPEATY )
+            {
+                y %= tex.height;
+                if( y < 0 ) y += tex.height;
+            }
+            else
+                y = clamp(y,0,tex.height-1);
+
+            const float k = 1.0f/255.0f;
+            if( tex.type == NVG_TEXTURE_ALPHA )
+            {
+                out[0] = out[1] = out[2] = out[3] = tex.data[y*tex.width + x] * k;
+            }
+            else
+            {
+                const unsigned char* p = &tex.data[(y*tex.width + x)*4];
+                out[0] = p[0]*k;
+                out[1] = p[1]*k;
+                out[2] = p[2]*k;
+                out[3] = p[3]*k;
+                if( !(tex.flags & NVG_IMAGE_PREMULTIPLIED) )
+                {
+                    out[0] *= out[3];
+                    out[1] *= out[3];
+                    out[2] *= out[3];
+                }
+            }
+        }
+
+        /// Sample a texture with normalized coordinates, the color is premultiplied
+        void sample(const Texture& tex,float u,float v,float* out)
+        {
+            if( tex.flags & NVG_IMAGE_FLIPY )
+                v = 1.0f - v;
+            float tx = u * tex.width - 0.5f;
+            float ty = v * tex.height - 0.5f;
+            if( tex.flags & NVG_IMAGE_NEAREST )
+            {
+                fetch(tex,(int)std::floor(tx + 0.5f),(int)std::floor(ty + 0.5f),out);
+                return;
+            }
+            float fx = std::floor(tx);
+            float fy = std::floor(ty);
+            float wx = tx - fx;
+            float wy = ty - fy;
+            int x0 = (int)fx;
+            int y0 = (int)fy;
+            float c00[4],c10[4],c01[4],c11[4];
+            fetch(tex,x0,y0,c00);
+            fetch(tex,x0+1,y0,c10);
+            fetch(tex,x0,y0+1,c01);
+            fetch(tex,x0+1,y0+1,c11);
+            for( int i = 0 ; i < 4 ; ++i )
+            {
+                float top = c00[i] + (c10[i] - c00[i]) * wx;
+                float bottom = c01[i] + (c11[i] - c01[i]) * wx;
+                out[i] = top + (bottom - top) * wy;
+            }
+        }
+
+        /// Blend factor of NanoVG composite operations
+        inline float blendFactor(int factor,float srcC,float srcA,float dstC,float dstA)
+        {
+            switch(factor)
+            {
+                case NVG_ZERO:                return 0.0f;
+                case NVG_ONE:                 return 1.0f;
+                case NVG_SRC_COLOR:           return srcC;
+                case NVG_ONE_MINUS_SRC_COLOR: return 1.0f - srcC;
+                case NVG_DST_COLOR:           return dstC;
+                case NVG_ONE_MINUS_DST_COLOR: return 1.0f - dstC;
+                case NVG_SRC_ALPHA:           return srcA;
+                case NVG_ONE_MINUS_SRC_ALPHA: return 1.0f - srcA;
+                case NVG_DST_ALPHA:           return dstA;
+                case NVG_ONE_MINUS_DST_ALPHA: return 1.0f - dstA;
+                case NVG_SRC_ALPHA_SATURATE:  return std::min(srcA,1.0f - dstA);
+                default:                      return 0.0f;
+            }
+        }
+    }
+
+    /// The rasterizer state, shared with the NanoVG render callbacks through the user pointer
+    struct SoftwareRenderer::Backend
+    {
+        /// The premultiplied RGBA pixel buffer
+        std::vector<unsigned char> pixels;
+        int width  = 0;
+        int height = 0;
+        float viewWidth  = 0.0f;
+        float viewHeight = 0.0f;
+
+        std::vector<Texture>  textures;
+        std::vector<Call>     calls;
+        std::vector<CallPath> paths;
+        std::vector<NVGvertex> verts;
+
+        /// Coverage accumulation buffer of the current call
+        std::vector<float> acc;
+        /// Resolved coverage of a row
+        std::vector<float> cover;
+        /// Shaded source pixels of a row
+        std::vector<unsigned char> span;
+        /// The pixel origin and size of the accumulation buffer
+        int ox = 0, oy = 0, bw = 0, bh = 0;
+        /// Scale from view space to pixels
+        float sx = 1.0f, sy = 1.0f;
+
+        Texture* texture(int image)
+        {
+            if( image <= 0 || image > (int)textures.size() || !textures[image-1].used )
+                return nullptr;
+            return &textures[image-1];
+        }
+
+    /*------------------- Coverage accumulation -------------------*/
+
+        /// Accumulate the signed area of a line inside the buffer, x in [0,bw] and y in [0,bh]
+        void accumulateLine(float x0,float y0,float x1,float y1)
+        {
+            if( y0 == y1 )
+                return;
+            float dir = 1.0f;
+            if( y0 > y1 )
+            {
+                std::swap(x0,x1);
+                std::swap(y0,y1);
+                dir = -1.0f;
+            }
+            const int stride = bw + 2;
+            float dxdy = (x1 - x0) / (y1 - y0);
+            float x = x0;
+            int yStart = (int)y0;
+            int yEnd = std::min(bh,(int)std::ceil(y1));
+            for( int y = yStart ; y < yEnd ; ++y )
+            {
+                float* row = &acc[y*stride];
+                float dy = std::min((float)(y+1),y1) - std::max((float)y,y0);
+                float xnext = x + dxdy * dy;
+                float d = dy * dir;
+                float xa = std::min(x,xnext);
+                float xb = std::max(x,xnext);
+                float xaFloor = std::floor(xa);
+                int xai = (int)xaFloor;
+                float xbCeil = std::ceil(xb);
+                int xbi = (int)xbCeil;
+                if( xbi <= xai + 1 )
+                {
+                    float xmf = 0.5f * (x + xnext) - xaFloor;
+                    row[xai] += d - d * xmf;
+                    row[xai+1] += d * xmf;
+                }
+                else
+                {
+                    float s = 1.0f / (xb - xa);
+                    float xaf = xa - xaFloor;
+                    float a0 = 0.5f * s * (1.0f - xaf) * (1.0f - xaf);
+                    float xbf = xb - xbCeil + 1.0f;
+                    float am = 0.5f * s * xbf * xbf;
+                    row[xai] += d * a0;
+                    if( xbi == xai + 2 )
+                        row[xai+1] += d * (1.0f - a0 - am);
+                    else
+                    {
+                        float a1 = s * (1.5f - xaf);
+                        row[xai+1] += d * (a1 - a0);
+                        for( int xi = xai + 2 ; xi < xbi - 1 ; ++xi )
+                            row[xi] += d * s;
+                        float a2 = a1 + (xbi - xai - 3) * s;
+                        row[xbi-1] += d * (1.0f - a2 - am);
+                    }
+                    row[xbi] += d * am;
+                }
+                x = xnext;
+            }
+        }
+
+        /// Add an edge in view space, clipped to the accumulation buffer
+        void addEdge(float x0,float y0,float x1,float y1)
+        {
+            x0 = x0*sx - ox; y0 = y0*sy - oy;
+            x1 = x1*sx - ox; y1 = y1*sy - oy;
+            float h = (float)bh;
+            float w = (float)bw;
+
+            // Rows outside the buffer are not visible
+            if( (y0 <= 0.0f && y1 <= 0.0f) || (y0 >= h && y1 >= h) || y0 == y1 )
+                return;
+            if( y0 < 0.0f || y1 < 0.0f )
+            {
+                float t = (0.0f - y0) / (y1 - y0);
+                float xc = x0 + (x1 - x0) * t;
+                if( y0 < 0.0f ){ x0 = xc; y0 = 0.0f; }
+                else           { x1 = xc; y1 = 0.0f; }
+            }
+            if( y0 > h || y1 > h )
+            {
+                float t = (h - y0) / (y1 - y0);
+                float xc = x0 + (x1 - x0) * t;
+                if( y0 > h ){ x0 = xc; y0 = h; }
+                else        { x1 = xc; y1 = h; }
+            }
+
+            // Edges right of the buffer only affect hidden pixels,
+            // edges left of the buffer cover the whole row like a vertical line at 0
+            if( x0 >= w && x1 >= w )
+                return;
+            if( x0 > w || x1 > w )
+            {
+                float t = (w - x0) / (x1 - x0);
+                float yc = y0 + (y1 - y0) * t;
+                if( x0 > w ){ x0 = w; y0 = yc; }
+                else        { x1 = w; y1 = yc; }
+            }
+            if( x0 < 0.0f && x1 < 0.0f )
+            {
+                accumulateLine(0.0f,y0,0.0f,y1);
+                return;
+            }
+            if( x0 < 0.0f || x1 < 0.0f )
+            {
+                float t = (0.0f - x0) / (x1 - x0);
+                float yc = y0 + (y1 - y0) * t;
+                if( x0 < 0.0f )
+                {
+                    accumulateLine(0.0f,y0,0.0f,yc);
+                    x0 = 0.0f; y0 = yc;
+                }
+                else
+                {
+                    accumulateLine(0.0f,yc,0.0f,y1);
+                    x1 = 0.0f; y1 = yc;
+                }
+            }
+            accumulateLine(x0,y0,x1,y1);
+        }
+
+        /// Add a triangle with positive orientation
+        void addTriangle(const NVGvertex& a,const NVGvertex& b,const NVGvertex& c)
+        {
+            float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+            if( area == 0.0f )
+                return;
+            if( area > 0.0f )
+            {
+                addEdge(a.x,a.y,b.x,b.y);
+                addEdge(b.x,b.y,c.x,c.y);
+                addEdge(c.x,c.y,a.x,a.y);
+            }
+            else
+            {
+                addEdge(a.x,a.y,c.x,c.y);
+                addEdge(c.x,c.y,b.x,b.y);
+                addEdge(b.x,b.y,a.x,a.y);
+            }
+        }
+
+        /**
+         * @brief Prepare the accumulation buffer for a view space bounding box
+         * @return Is there any visible pixel in the box
+         */
+        bool beginCoverage(float minx,float miny,float maxx,float maxy,const Shader& shader,
+                           const NVGscissor& scissor)
+        {
+            if( shader.scissor )
+            {
+                // Nothing is visible outside of the scissor bounds
+                float ex = scissor.extent[0] + 1.0f;
+                float ey = scissor.extent[1] + 1.0f;
+                float cx[4],cy[4];
+                transformPoint(scissor.xform,-ex,-ey,cx[0],cy[0]);
+                transformPoint(scissor.xform, ex,-ey,cx[1],cy[1]);
+                transformPoint(scissor.xform, ex, ey,cx[2],cy[2]);
+                transformPoint(scissor.xform,-ex, ey,cx[3],cy[3]);
+                minx = std::max(minx,std::min(std::min(cx[0],cx[1]),std::min(cx[2],cx[3])));
+                maxx = std::min(maxx,std::max(std::max(cx[0],cx[1]),std::max(cx[2],cx[3])));
+                miny = std::max(miny,std::min(std::min(cy[0],cy[1]),std::min(cy[2],cy[3])));
+                maxy = std::min(maxy,std::max(std::max(cy[0],cy[1]),std::max(cy[2],cy[3])));
+            }
+            int x0 = std::max(0,(int)std::floor(minx*sx));
+            int y0 = std::max(0,(int)std::floor(miny*sy));
+            int x1 = std::min(width,(int)std::ceil(maxx*sx) + 1);
+            int y1 = std::min(height,(int)std::ceil(maxy*sy) + 1);
+            if( x0 >= x1 || y0 >= y1 )
+                return false;
+            ox = x0;
+            oy = y0;
+            bw = x1 - x0;
+            bh = y1 - y0;
+            acc.assign((size_t)(bw+2)*bh,0.0f);
+            if( (int)cover.size() < bw + 4 )
+            {
+                cover.resize(bw + 4);
+                span.resize((bw + 4)*4);
+            }
+            return true;
+        }
+
+        /// Prefix sum of an accumulation row into coverage values in range [0,1]
+        void resolveRow(const float* row)
+        {
+            int x = 0;
+            float sum = 0.0f;
+#ifdef NANOCANVAS_SSE2
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128 one = _mm_set1_ps(1.0f);
+            __m128 carry = _mm_setzero_ps();
+            for( ; x + 4 <= bw ; x += 4 )
+            {
+                __m128 v = _mm_loadu_ps(row + x);
+                v = _mm_add_ps(v,_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v),4)));
+                v = _mm_add_ps(v,_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v),8)));
+                v = _mm_add_ps(v,carry);
+                carry = _mm_shuffle_ps(v,v,_MM_SHUFFLE(3,3,3,3));
+                _mm_storeu_ps(&cover[x],_mm_min_ps(_mm_andnot_ps(signMask,v),one));
+            }
+            _mm_store_ss(&sum,carry);
+#endif
+            for( ; x < bw ; ++x )
+            {
+                sum += row[x];
+                cover[x] = std::min(std::fabs(sum),1.0f);
+            }
+        }
+
+    /*------------------------- Shading -------------------------*/
+
+        void setupShader(Shader& shader,const Call& call)
+        {
+            const NVGpaint& paint = call.paint;
+            premultiply(paint.innerColor,shader.inner);
+            premultiply(paint.outerColor,shader.outer);
+            shader.texture = texture(paint.image);
+            shader.extent[0] = paint.extent[0];
+            shader.extent[1] = paint.extent[1];
+            shader.radius = paint.radius;
+            shader.feather = paint.feather;
+            inverseTransform(shader.paintMat,paint.xform);
+            shader.solid = call.type != CallType::Triangles && !shader.texture &&
+                           std::memcmp(shader.inner,shader.outer,sizeof(shader.inner)) == 0;
+
+            const NVGscissor& scissor = call.scissor;
+            shader.scissor = !(scissor.extent[0] < -0.5f || scissor.extent[1] < -0.5f);
+            if( shader.scissor )
+            {
+                const float* t = scissor.xform;
+                float fringe = call.fringe > 0.0f ? call.fringe : 1.0f;
+                inverseTransform(shader.scissorMat,t);
+                shader.scissorExt[0] = scissor.extent[0];
+                shader.scissorExt[1] = scissor.extent[1];
+                shader.scissorScale[0] = std::sqrt(t[0]*t[0] + t[2]*t[2]) / fringe;
+                shader.scissorScale[1] = std::sqrt(t[1]*t[1] + t[3]*t[3]) / fringe;
+                // An axis-aligned scissor masks by rows and columns, the columns
+                // far enough from its edges don't need the per pixel mask
+                shader.scissorAligned = t[1] == 0.0f && t[2] == 0.0f && t[0] != 0.0f && t[3] != 0.0f;
+                if( shader.scissorAligned )
+                {
+                    float half = std::fabs(t[0])*scissor.extent[0] - 0.5f*fringe;
+                    float x0 = std::ceil((t[4] - half)*sx - 0.5f);
+                    float x1 = std::floor((t[4] + half)*sx - 0.5f) + 1.0f;
+                    shader.scissorX0 = (int)clamp(x0,0.0f,(float)width);
+                    shader.scissorX1 = (int)clamp(x1,(float)shader.scissorX0,(float)width);
+                }
+            }
+        }
+
+        inline float scissorMask(const Shader& shader,float x,float y)
+        {
+            float px,py;
+            transformPoint(shader.scissorMat,x,y,px,py);
+            float mx = 0.5f - (std::fabs(px) - shader.scissorExt[0]) * shader.scissorScale[0];
+            float my = 0.5f - (std::fabs(py) - shader.scissorExt[1]) * shader.scissorScale[1];
+            return clamp(mx,0.0f,1.0f) * clamp(my,0.0f,1.0f);
+        }
+
+        /// Shade one pixel in view space, the color is premultiplied in range [0,1]
+        inline void shade(const Shader& shader,const UVMap* uv,float x,float y,float* out)
+        {
+            if( uv )
+            {
+                float u = uv->u[0]*x + uv->u[1]*y + uv->u[2];
+                float v = uv->v[0]*x + uv->v[1]*y + uv->v[2];
+                if( shader.texture )
+                    sample(*shader.texture,u,v,out);
+                else
+                    out[0] = out[1] = out[2] = out[3] = 1.0f;
+                for( int i = 0 ; i < 4 ; ++i )
+                    out[i] *= shader.inner[i];
+                return;
+            }
+            float px,py;
+            transformPoint(shader.paintMat,x,y,px,py);
+            if( shader.texture )
+            {
+                sample(*shader.texture,px / shader.extent[0],py / shader.extent[1],out);
+                for( int i = 0 ; i < 4 ; ++i )
+                    out[i] *= shader.inner[i];
+            }
+            else
+            {
+                float feather = std::max(shader.feather,1e-4f);
+                float d = sdroundrect(px,py,shader.extent[0],shader.extent[1],shader.radius);
+                d = clamp((d + shader.feather*0.5f) / feather,0.0f,1.0f);
+                for( int i = 0 ; i < 4 ; ++i )
+                    out[i] = shader.inner[i] + (shader.outer[i] - shader.inner[i]) * d;
+            }
+        }
+
+        /// Shade a run of covered pixels of row y into the span buffer
+        void shadeRun(const Shader& shader,const UVMap* uv,int y,int xs,int xe)
+        {
+            unsigned char* out = &span[xs*4];
+            const float* cov = &cover[xs];
+            int n = xe - xs;
+            if( shader.solid )
+            {
+                int i = 0;
+#ifdef NANOCANVAS_SSE2
+                // Same order and rounding as the scalar tail: inner * cov * 255 + 0.5, truncated
+                const __m128 color = _mm_setr_ps(shader.inner[0],shader.inner[1],
+                                                 shader.inner[2],shader.inner[3]);
+                const __m128 scale = _mm_set1_ps(255.0f);
+                const __m128 half = _mm_set1_ps(0.5f);
+                auto toBytes = [&](__m128 c)
+                {
+                    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(color,c),scale),half));
+                };
+                for( ; i + 4 <= n ; i += 4 )
+                {
+                    __m128 c = _mm_loadu_ps(cov + i);
+                    __m128i p0 = toBytes(_mm_shuffle_ps(c,c,_MM_SHUFFLE(0,0,0,0)));
+                    __m128i p1 = toBytes(_mm_shuffle_ps(c,c,_MM_SHUFFLE(1,1,1,1)));
+                    __m128i p2 = toBytes(_mm_shuffle_ps(c,c,_MM_SHUFFLE(2,2,2,2)));
+                    __m128i p3 = toBytes(_mm_shuffle_ps(c,c,_MM_SHUFFLE(3,3,3,3)));
+                    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(p0,p1),_mm_packs_epi32(p2,p3));
+                    _mm_storeu_si128((__m128i*)(out + i*4),packed);
+                }
+#endif
+                for( ; i < n ; ++i )
+                    for( int k = 0 ; k < 4 ; ++k )
+                        out[i*4+k] = (unsigned char)(shader.inner[k] * cov[i] * 255.0f + 0.5f);
+                return;
+            }
+
+            float fy = (y + 0.5f) / sy;
+            for( int i = 0 ; i < n ; ++i )
+            {
+                float fx = (xs + ox + i + 0.5f) / sx;
+                float color[4];
+                shade(shader,uv,fx,fy,color);
+                for( int k = 0 ; k < 4 ; ++k )
+                    out[i*4+k] = (unsigned char)(clamp(color[k] * cov[i],0.0f,1.0f) * 255.0f + 0.5f);
+            }
+        }
+
+    /*------------------------ Compositing ------------------------*/
+
+        /// Composite premultiplied source pixels over the destination
+        void sourceOver(const unsigned char* src,unsigned char* dst,int n)
+        {
+            int i = 0;
+#ifdef NANOCANVAS_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i c255 = _mm_set1_epi16(255);
+            const __m128i c128 = _mm_set1_epi16(128);
+            for( ; i + 4 <= n ; i += 4 )
+            {
+                __m128i s = _mm_loadu_si128((const __m128i*)(src + i*4));
+                __m128i d = _mm_loadu_si128((const __m128i*)(dst + i*4));
+                __m128i sLo = _mm_unpacklo_epi8(s,zero);
+                __m128i sHi = _mm_unpackhi_epi8(s,zero);
+                __m128i aLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sLo,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(3,3,3,3));
+                __m128i aHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sHi,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(3,3,3,3));
+                __m128i dLo = _mm_mullo_epi16(_mm_unpacklo_epi8(d,zero),_mm_sub_epi16(c255,aLo));
+                __m128i dHi = _mm_mullo_epi16(_mm_unpackhi_epi8(d,zero),_mm_sub_epi16(c255,aHi));
+                // x/255 rounded as (t + (t>>8)) >> 8 with t = x + 128
+                dLo = _mm_add_epi16(dLo,c128);
+                dHi = _mm_add_epi16(dHi,c128);
+                dLo = _mm_srli_epi16(_mm_add_epi16(dLo,_mm_srli_epi16(dLo,8)),8);
+                dHi = _mm_srli_epi16(_mm_add_epi16(dHi,_mm_srli_epi16(dHi,8)),8);
+                _mm_storeu_si128((__m128i*)(dst + i*4),_mm_adds_epu8(_mm_packus_epi16(dLo,dHi),s));
+            }
+#endif
+            for( ; i < n ; ++i )
+            {
+                const unsigned char* s = src + i*4;
+                unsigned char* d = dst + i*4;
+                unsigned inv = 255U - s[3];
+                for( int k = 0 ; k < 4 ; ++k )
+                {
+                    unsigned t = d[k] * inv + 128U;
+                    d[k] = (unsigned char)std::min(255U,s[k] + ((t + (t >> 8)) >> 8));
+                }
+            }
+        }
+
+        /// Composite with any NanoVG blend factors
+        void composite(const NVGcompositeOperationState& op,
+                       const unsigned char* src,unsigned char* dst,int n)
+        {
+            if( op.srcRGB == NVG_ONE && op.dstRGB == NVG_ONE_MINUS_SRC_ALPHA &&
+                op.srcAlpha == NVG_ONE && op.dstAlpha == NVG_ONE_MINUS_SRC_ALPHA )
+            {
+                sourceOver(src,dst,n);
+                return;
+            }
+            const float k = 1.0f/255.0f;
+            for( int i = 0 ; i < n ; ++i )
+            {
+                const unsigned char* s = src + i*4;
+                unsigned char* d = dst + i*4;
+                float sa = s[3]*k;
+                float da = d[3]*k;
+                for( int c = 0 ; c < 4 ; ++c )
+                {
+                    float sc = s[c]*k;
+                    float dc = d[c]*k;
+                    int fs = c < 3 ? op.srcRGB : op.srcAlpha;
+                    int fd = c < 3 ? op.dstRGB : op.dstAlpha;
+                    float r = sc * blendFactor(fs,sc,sa,dc,da) + dc * blendFactor(fd,sc,sa,dc,da);
+                    d[c] = (unsigned char)(clamp(r,0.0f,1.0f) * 255.0f + 0.5f);
+                }
+            }
+        }
+
+        /// Shade and composite the covered pixels of the accumulation buffer
+        void resolve(const Call& call,const Shader& shader,const UVMap* uv)
+        {
+            const int stride = bw + 2;
+            const float threshold = 1.0f / 512.0f;
+            for( int row = 0 ; row < bh ; ++row )
+            {
+                int y = oy + row;
+                resolveRow(&acc[row*stride]);
+                if( shader.scissor && shader.scissorAligned )
+                {
+                    float fy = (y + 0.5f) / sy;
+                    float py = shader.scissorMat[3]*fy + shader.scissorMat[5];
+                    float my = clamp(0.5f - (std::fabs(py) - shader.scissorExt[1]) * shader.scissorScale[1],0.0f,1.0f);
+                    if( my <= 0.0f )
+                        continue;
+                    // Only the columns near the scissor edges need the full mask
+                    int ix0 = clamp(shader.scissorX0 - ox,0,bw);
+                    int ix1 = clamp(shader.scissorX1 - ox,ix0,bw);
+                    for( int x = 0 ; x < ix0 ; ++x )
+                        if( cover[x] > 0.0f )
+                            cover[x] *= scissorMask(shader,(ox + x + 0.5f) / sx,fy);
+                    for( int x = ix1 ; x < bw ; ++x )
+                        if( cover[x] > 0.0f )
+                            cover[x] *= scissorMask(shader,(ox + x + 0.5f) / sx,fy);
+                    if( my < 1.0f )
+                        for( int x = ix0 ; x < ix1 ; ++x )
+                            cover[x] *= my;
+                }
+                else if( shader.scissor )
+                {
+                    float fy = (y + 0.5f) / sy;
+                    for( int x = 0 ; x < bw ; ++x )
+                        if( cover[x] > 0.0f )
+                            cover[x] *= scissorMask(shader,(ox + x + 0.5f) / sx,fy);
+                }
+
+                unsigned char* dst = &pixels[((size_t)y*width + ox)*4];
+                int x = 0;
+                while( x < bw )
+                {
+                    while( x < bw && cover[x] < threshold )
+                        ++x;
+                    int xs = x;
+                    while( x < bw && cover[x] >= threshold )
+                        ++x;
+                    if( x > xs )
+                    {
+                        shadeRun(shader,uv,y,xs,x);
+                        composite(call.op,&span[xs*4],dst + xs*4,x - xs);
+                    }
+                }
+            }
+        }
+
+    /*------------------------- Render calls -------------------------*/
+
+        void renderFill(const Call& call)
+        {
+            Shader shader;
+            setupShader(shader,call);
+            float minx = 1e30f, miny = 1e30f, maxx = -1e30f, maxy = -1e30f;
+            for( int p = 0 ; p < call.pathCount ; ++p )
+            {
+                const CallPath& path = paths[call.pathOffset + p];
+                for( int i = 0 ; i < path.fillCount ; ++i )
+                {
+                    const NVGvertex& v = verts[path.fillOffset + i];
+                    minx = std::min(minx,v.x); maxx = std::max(maxx,v.x);
+                    miny = std::min(miny,v.y); maxy = std::max(maxy,v.y);
+                }
+            }
+            if( !beginCoverage(minx,miny,maxx,maxy,shader,call.scissor) )
+                return;
+            for( int p = 0 ; p < call.pathCount ; ++p )
+            {
+                const CallPath& path = paths[call.pathOffset + p];
+                const NVGvertex* v = &verts[path.fillOffset];
+                for( int i = 0 , j = path.fillCount - 1 ; i < path.fillCount ; j = i++ )
+                    addEdge(v[j].x,v[j].y,v[i].x,v[i].y);
+            }
+            resolve(call,shader,nullptr);
+        }
+
+        void renderStroke(const Call& call)
+        {
+            Shader shader;
+            setupShader(shader,call);
+            float minx = 1e30f, miny = 1e30f, maxx = -1e30f, maxy = -1e30f;
+            for( int p = 0 ; p < call.pathCount ; ++p )
+            {
+                const CallPath& path = paths[call.pathOffset + p];
+                for( int i = 0 ; i < path.strokeCount ; ++i )
+                {
+                    const NVGvertex& v = verts[path.strokeOffset + i];
+                    minx = std::min(minx,v.x); maxx = std::max(maxx,v.x);
+                    miny = std::min(miny,v.y); maxy = std::max(maxy,v.y);
+                }
+            }
+            if( !beginCoverage(minx,miny,maxx,maxy,shader,call.scissor) )
+                return;
+            // Stroke triangle strips, overlapped triangles are clamped by the coverage
+            for( int p = 0 ; p < call.pathCount ; ++p )
+            {
+                const CallPath& path = paths[call.pathOffset + p];
+                const NVGvertex* v = &verts[path.strokeOffset];
+                for( int i = 0 ; i + 2 < path.strokeCount ; ++i )
+                    addTriangle(v[i],v[i+1],v[i+2]);
+            }
+            resolve(call,shader,nullptr);
+        }
+
+        /// Solve the affine texture mapping of a triangle
+        static bool solveUV(const NVGvertex* t,UVMap& map)
+        {
+            float x1 = t[1].x - t[0].x, y1 = t[1].y - t[0].y;
+            float x2 = t[2].x - t[0].x, y2 = t[2].y - t[0].y;
+            float det = x1*y2 - x2*y1;
+            if( std::fabs(det) < 1e-8f )
+                return false;
+            float u1 = t[1].u - t[0].u, u2 = t[2].u - t[0].u;
+            float v1 = t[1].v - t[0].v, v2 = t[2].v - t[0].v;
+            map.u[0] = (u1*y2 - u2*y1) / det;
+            map.u[1] = (u2*x1 - u1*x2) / det;
+            map.u[2] = t[0].u - map.u[0]*t[0].x - map.u[1]*t[0].y;
+            map.v[0] = (v1*y2 - v2*y1) / det;
+            map.v[1] = (v2*x1 - v1*x2) / det;
+            map.v[2] = t[0].v - map.v[0]*t[0].x - map.v[1]*t[0].y;
+            return true;
+        }
+
+        static bool fitsUV(const NVGvertex* t,const UVMap& map)
+        {
+            for( int i = 0 ; i < 3 ; ++i )
+            {
+                float u = map.u[0]*t[i].x + map.u[1]*t[i].y + map.u[2];
+                float v = map.v[0]*t[i].x + map.v[1]*t[i].y + map.v[2];
+                if( std::fabs(u - t[i].u) > 1e-4f || std::fabs(v - t[i].v) > 1e-4f )
+                    return false;
+            }
+            return true;
+        }
+
+        void renderTriangles(const Call& call)
+        {
+            Shader shader;
+            setupShader(shader,call);
+            const NVGvertex* v = &verts[call.vertexOffset];
+            int count = call.vertexCount / 3;
+            int i = 0;
+            while( i < count )
+            {
+                // Consecutive triangles sharing the same texture mapping (glyph quads)
+                // are rasterized together so their shared edges do not leave seams
+                UVMap map;
+                if( !solveUV(v + i*3,map) )
+                {
+                    ++i;
+                    continue;
+                }
+                int end = i + 1;
+                while( end < count && fitsUV(v + end*3,map) )
+                    ++end;
+
+                float minx = 1e30f, miny = 1e30f, maxx = -1e30f, maxy = -1e30f;
+                for( int k = i*3 ; k < end*3 ; ++k )
+                {
+                    minx = std::min(minx,v[k].x); maxx = std::max(maxx,v[k].x);
+                    miny = std::min(miny,v[k].y); maxy = std::max(maxy,v[k].y);
+                }
+                if( beginCoverage(minx,miny,maxx,maxy,shader,call.scissor) )
+                {
+                    for( int k = i ; k < end ; ++k )
+                        addTriangle(v[k*3],v[k*3+1],v[k*3+2]);
+                    resolve(call,shader,&map);
+                }
+                i = end;
+            }
+        }
+
+        void flush()
+        {
+            for( const Call& call : calls )
+            {
+                switch(call.type)
+                {
+                    case CallType::Fill:      renderFill(call); break;
+                    case CallType::Stroke:    renderStroke(call); break;
+                    case CallType::Triangles: renderTriangles(call); break;
+                }
+            }
+            cancel();
+        }
+
+        void cancel()
+        {
+            calls.clear();
+            paths.clear();
+            verts.clear();
+        }
+
+        Call& addCall(CallType type,const NVGpaint* paint,
+                      const NVGcompositeOperationState& op,
+                      const NVGscissor* scissor,float fringe)
+        {
+            Call call;
+            call.type = type;
+            call.paint = *paint;
+            call.op = op;
+            call.scissor = *scissor;
+            call.fringe = fringe;
+            call.pathOffset = (int)paths.size();
+            call.pathCount = 0;
+            call.vertexOffset = (int)verts.size();
+            call.vertexCount = 0;
+            calls.push_back(call);
+            return calls.back();
+        }
+
+        void addPaths(Call& call,const NVGpath* npaths,int npath,bool fill)
+        {
+            for( int i = 0 ; i < npath ; ++i )
+            {
+                const NVGpath& src = npaths[i];
+                CallPath path;
+                path.fillOffset = (int)verts.size();
+                path.fillCount = 0;
+                path.strokeOffset = path.fillOffset;
+                path.strokeCount = 0;
+                if( fill && src.nfill > 0 )
+                {
+                    path.fillCount = src.nfill;
+                    verts.insert(verts.end(),src.fill,src.fill + src.nfill);
+                }
+                if( !fill && src.nstroke > 0 )
+                {
+                    path.strokeCount = src.nstroke;
+                    verts.insert(verts.end(),src.stroke,src.stroke + src.nstroke);
+                }
+                paths.push_back(path);
+            }
+            call.pathCount = npath;
+        }
+
+    /*--------------------- NanoVG render callbacks -----------------------*/
+
+        static int renderCreateCallback(void* )
+        {
+            return 1;
+        }
+
+        static int createTextureCallback(void* uptr,int type,int w,int h,int imageFlags,
+                                         const unsigned char* data)
+        {
+            Backend* backend = (Backend*)uptr;
+            size_t slot = 0;
+            while( slot < backend->textures.size() && backend->textures[slot].used )
+                ++slot;
+            if( slot == backend->textures.size() )
+                backend->textures.emplace_back();
+
+            Texture& tex = backend->textures[slot];
+            tex.width = w;
+            tex.height = h;
+            tex.type = type;
+            tex.flags = imageFlags;
+            tex.used = true;
+            size_t bytes = (size_t)w * h * (type == NVG_TEXTURE_RGBA ? 4 : 1);
+            if( data )
+                tex.data.assign(data,data + bytes);
+            else
+                tex.data.assign(bytes,0);
+            return (int)slot + 1;
+        }
+
+        static int deleteTextureCallback(void* uptr,int image)
+        {
+            Texture* tex = ((Backend*)uptr)->texture(image);
+            if( !tex )
+                return 0;
+            tex->used = false;
+            std::vector<unsigned char>().swap(tex->data);
+            return 1;
+        }
+
+        static int updateTextureCallback(void* uptr,int image,int x,int y,int w,int h,
+                                         const unsigned char* data)
+        {
+            Texture* tex = ((Backend*)uptr)->texture(image);
+            if( !tex || !data )
+                return 0;
+            // The data is the whole image, only the given region is updated
+            int bpp = tex->type == NVG_TEXTURE_RGBA ? 4 : 1;
+            for( int row = y ; row < y + h && row < tex->height ; ++row )
+            {
+                size_t offset = ((size_t)row * tex->width + x) * bpp;
+                std::memcpy(&tex->data[offset],data + offset,(size_t)w * bpp);
+            }
+            return 1;
+        }
+
+        static int getTextureSizeCallback(void* uptr,int image,int* w,int* h)
+        {
+            Texture* tex = ((Backend*)uptr)->texture(image);
+            if( !tex )
+                return 0;
+            *w = tex->width;
+            *h = tex->height;
+            return 1;
+        }
+
+        static void viewportCallback(void* uptr,float width,float height,float )
+        {
+            Backend* backend = (Backend*)uptr;
+            backend->viewWidth = width;
+            backend->viewHeight = height;
+            backend->sx = width > 0.0f ? backend->width / width : 1.0f;
+            backend->sy = height > 0.0f ? backend->height / height : 1.0f;
+        }
+
+        static void cancelCallback(void* uptr)
+        {
+            ((Backend*)uptr)->cancel();
+        }
+
+        static void flushCallback(void* uptr)
+        {
+            ((Backend*)uptr)->flush();
+        }
+
+        static void fillCallback(void* uptr,NVGpaint* paint,NVGcompositeOperationState op,
+                                 NVGscissor* scissor,float fringe,const float* ,
+                                 const NVGpath* paths,int npaths)
+        {
+            Backend* backend = (Backend*)uptr;
+            Call& call = backend->addCall(CallType::Fill,paint,op,scissor,fringe);
+            backend->addPaths(call,paths,npaths,true);
+        }
+
+        static void strokeCallback(void* uptr,NVGpaint* paint,NVGcompositeOperationState op,
+                                   NVGscissor* scissor,float fringe,float ,
+                                   const NVGpath* paths,int npaths)
+        {
+            Backend* backend = (Backend*)uptr;
+            Call& call = backend->addCall(CallType::Stroke,paint,op,scissor,fringe);
+            backend->addPaths(call,paths,npaths,false);
+        }
+
+        static void trianglesCallback(void* uptr,NVGpaint* paint,NVGcompositeOperationState op,
+                                      NVGscissor* scissor,const NVGvertex* verts,
+                                      int nverts,float fringe)
+        {
+            Backend* backend = (Backend*)uptr;
+            Call& call = backend->addCall(CallType::Triangles,paint,op,scissor,fringe);
+            call.vertexCount = nverts;
+            backend->verts.insert(backend->verts.end(),verts,verts + nverts);
+        }
+
+        static void renderDeleteCallback(void* )
+        {
+        }
+    };
+
+/*------------------------- SoftwareRenderer --------------------------*/
+
+    SoftwareRenderer::SoftwareRenderer(int width,int height)
+    {
+        m_backend = new Backend();
+        resize(width,height);
+
+        NVGparams params;
+        std::memset(&params,0,sizeof(params));
+        params.userPtr = m_backend;
+        // The rasterizer computes exact area coverage, NanoVG fringes are not needed
+        params.edgeAntiAlias = 0;
+        params.renderCreate = Backend::renderCreateCallback;
+        params.renderCreateTexture = Backend::createTextureCallback;
+        params.renderDeleteTexture = Backend::deleteTextureCallback;
+        params.renderUpdateTexture = Backend::updateTextureCallback;
+        params.renderGetTextureSize = Backend::getTextureSizeCallback;
+        params.renderViewport = Backend::viewportCallback;
+        params.renderCancel = Backend::cancelCallback;
+        params.renderFlush = Backend::flushCallback;
+        params.renderFill = Backend::fillCallback;
+        params.renderStroke = Backend::strokeCallback;
+        params.renderTriangles = Backend::trianglesCallback;
+        params.renderDelete = Backend::renderDeleteCallback;
+        m_nvgCtx = nvgCreateInternal(&params);
+    }
+
+    SoftwareRenderer::~SoftwareRenderer()
+    {
+        if( m_nvgCtx )
+            nvgDeleteInternal(m_nvgCtx);
+        delete m_backend;
+    }
+
+    void SoftwareRenderer::resize(int width,int height)
+    {
+        m_backend->width = std::max(width,0);
+        m_backend->height = std::max(height,0);
+        m_backend->pixels.assign((size_t)m_backend->width * m_backend->height * 4,0);
+    }
+
+    void SoftwareRenderer::clear(const Color& color)
+    {
+        float a = color.a / 255.0f;
+        unsigned char px[4] = {
+            (unsigned char)(color.r * a + 0.5f),
+            (unsigned char)(color.g * a + 0.5f),
+            (unsigned char)(color.b * a + 0.5f),
+            color.a
+        };
+        std::vector<unsigned char>& pixels = m_backend->pixels;
+        for( size_t i = 0 ; i < pixels.size() ; i += 4 )
+            std::memcpy(&pixels[i],px,4);
+    }
+
+    int SoftwareRenderer::width()const
+    {
+        return m_backend->width;
+    }
+
+    int SoftwareRenderer::height()const
+    {
+        return m_backend->height;
+    }
+
+    const unsigned char* SoftwareRenderer::pixels()const
+    {
+        return m_backend->pixels.data();
+    }
+
+    void SoftwareRenderer::readPixels(unsigned char* rgba)const
+    {
+        const std::vector<unsigned char>& pixels = m_backend->pixels;
+        for( size_t i = 0 ; i < pixels.size() ; i += 4 )
+        {
+            unsigned a = pixels[i+3];
+            for( int k = 0 ; k < 3 ; ++k )
+                rgba[i+k] = a ? (unsigned char)std::min(255U,(pixels[i+k] * 255U + a/2) / a) : 0;
+            rgba[i+3] = (unsigned char)a;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+namespace NanoCanvas
+{
+    /**
+     * @class SoftwareRenderer
+     * @brief Headless NanoVG backend which rasterizes into a RGBA pixel buffer in memory
+     *
+     * The renderer plugs into NanoVG through its internal render API, so a Canvas can
+     * be constructed on it exactly as on a GPU backend:
+     * @code
+     * SoftwareRenderer renderer(800,600);
+     * Canvas canvas(renderer.nvgContext(),800,600);
+     * canvas.begineFrame(800,600);
+     * // Draw awesome graphics here
+     * canvas.endFrame();
+     * const unsigned char* rgba = renderer.pixels();
+     * @endcode
+     *
+     * Fills, strokes and text are rasterized with analytic area coverage antialiasing.
+     * The coverage accumulation and the compositing of spans use SSE2 when available.
+     */
+    class SoftwareRenderer
+    {
+    public:
+        /**
+         * @brief Create a software renderer with a transparent pixel buffer
+         * @param width The width of the pixel buffer
+         * @param height The height of the pixel buffer
+         */
+        SoftwareRenderer(int width,int height);
+
+        ~SoftwareRenderer();
+
+        /// Delete copy constructor
+        SoftwareRenderer(const SoftwareRenderer&) = delete;
+        /// Disable assignment
+        SoftwareRenderer& operator=(const SoftwareRenderer&) = delete;
+
+        /// Check is the NanoVG context created
+        inline bool valid()const { return m_nvgCtx; }
+
+        /**
+         * @brief Get the NanoVG context to construct the canvas with
+         * @return The NanoVG context of this renderer
+         */
+        inline NVGcontext* nvgContext(){ return m_nvgCtx; }
+
+        /**
+         * @brief Resize the pixel buffer, the content is cleared
+         * @param width The new width of the pixel buffer
+         * @param height The new height of the pixel buffer
+         */
+        void resize(int width,int height);
+
+        /**
+         * @brief Fill the whole pixel buffer with a color
+         * @param color The color to fill with
+         */
+        void clear(const Color& color = Colors::ZeroColor);
+
+        /// The width of the pixel buffer
+        int width()const;
+
+        /// The height of the pixel buffer
+        int height()const;
+
+        /**
+         * @brief Get the rendered pixels
+         * @return The pixel buffer of width*height RGBA values with premultiplied alpha
+         */
+        const unsigned char* pixels()const;
+
+        /**
+         * @brief Copy the rendered pixels with straight alpha, ready for image encoders
+         * @param rgba [out] The buffer to store width*height*4 bytes
+         */
+        void readPixels(unsigned char* rgba)const;
+
+    private:
+        /// The rasterizer state shared with NanoVG callbacks
+        struct Backend;
+
+        /// The rasterizer of this renderer
+        Backend * m_backend = nullptr;
+        /// The NanoVG context driving the rasterizer
+        NVGcontext * m_nvgCtx = nullptr;
+    };
+}
+
+#endif // SOFTWARERENDERER_H
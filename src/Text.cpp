@@ -1,5 +1,7 @@
 #include "NanoCanvas.h"
 #include "nanovg.h"
+#include <cstdio>
+#include <cstring>
 
 namespace NanoCanvas
 {
@@ -8,6 +10,8 @@ namespace NanoCanvas
         if( canvas.valid() && fname.length() && ttfPath.length() )
         {
             face = nvgCreateFont(canvas.nvgContext(),fname.c_str(),ttfPath.c_str());
+            if( valid() )
+                canvas.m_fontSources.push_back({fname,ttfPath,nullptr,0UL});
         }
         name = fname;
     }
@@ -20,8 +24,170 @@ namespace NanoCanvas
             face = nvgCreateFontMem(canvas.nvgContext(),fname.c_str(),
                                         (unsigned char*)memory.data,
                                         memory.size,invalidateMem);
+            if( valid() )
+                canvas.m_fontSources.push_back({fname,nullstr,(const unsigned char*)memory.data,memory.size});
         }
         name = fname;
     }
+    
+    Font::Font(Canvas& canvas,const string& fname,const std::shared_ptr<MappedFile>& file)
+    {
+        if( canvas.valid() && file && file->valid() && fname.length() )
+        {
+            const Memery& memory = file->memory();
+            face = nvgCreateFontMem(canvas.nvgContext(),fname.c_str(),
+                                        (unsigned char*)memory.data,
+                                        memory.size,0);
+            if( valid() )
+            {
+                canvas.m_mappedFiles.push_back(file);
+                canvas.m_fontSources.push_back({fname,nullstr,(const unsigned char*)memory.data,memory.size});
+            }
+        }
+        name = fname;
+    }
+    
+    /// Check do two text styles lay out glyphs at the same positions
+    static bool sameLayout(const TextStyle& a,const TextStyle& b)
+    {
+        // Unset NAN fields are equal to each other
+        auto same = [](float x,float y){ return x == y || ( std::isnan(x) && std::isnan(y) ); };
+        return a.face == b.face && a.size == b.size &&
+               same(a.letterSpace,b.letterSpace) && same(a.lineHeight,b.lineHeight) &&
+               a.hAlign == b.hAlign && a.vAlign == b.vAlign;
+    }
+    
+    size_t NumberFormat::format(double value,char* buffer,size_t size)const
+    {
+        // The text is written backwards from the end of a stack buffer
+        char text[64];
+        char* end = text + sizeof(text);
+        char* p = end;
+        bool negative = std::signbit(value);
+        int digits = clamp(precision,0,9);
+        static const double Scales[] = { 1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9 };
+        double scaled = std::fabs(value)*Scales[digits] + 0.5;
+        if( std::isnan(value) )
+        {
+            p -= 3;
+            std::memcpy(p,"NaN",3);
+        }
+        else if( std::isinf(value) )
+        {
+            p -= 3;
+            std::memcpy(p,"Inf",3);
+        }
+        else if( scaled >= 9.0e18 )
+        {
+            int n = std::snprintf(text,sizeof(text),plus ? "%+.*e" : "%.*e",digits,value);
+            if( n <= 0 || (size_t)n >= sizeof(text) )
+                return 0;
+            std::replace(text,text + n,'.',decimal);
+            p = text;
+            end = text + n;
+            negative = false;
+        }
+        else
+        {
+            unsigned long long integer = (unsigned long long)scaled;
+            // Numbers rounded to zero have no sign
+            negative = negative && integer;
+            for( int i = 0 ; i < digits ; ++i , integer /= 10 )
+                *--p = (char)( '0' + integer % 10 );
+            if( digits )
+                *--p = decimal;
+            int group = 0;
+            do
+            {
+                if( thousands && group == 3 )
+                {
+                    *--p = thousands;
+                    group = 0;
+                }
+                *--p = (char)( '0' + integer % 10 );
+                integer /= 10;
+                ++group;
+            }
+            while( integer );
+        }
+        if( p != text )
+        {
+            if( negative )
+                *--p = '-';
+            else if( plus && !std::isnan(value) )
+                *--p = '+';
+        }
+        size_t length = (size_t)( end - p );
+        if( length > size )
+            return 0;
+        std::memcpy(buffer,p,length);
+        return length;
+    }
+    
+    TextLayout::TextLayout(const string& text,const TextStyle& style)
+    {
+        m_text = text;
+        m_style = style;
+    }
+    
+    void TextLayout::setText(const string& text)
+    {
+        setText(text.data(),text.data() + text.size());
+    }
+    
+    void TextLayout::setText(const char* text,const char* end)
+    {
+        size_t length = end ? (size_t)( end - text ) : std::strlen(text);
+        // Comparing in place doesn't allocate for texts which are set every frame
+        if( m_text.compare(0,string::npos,text,length) != 0 )
+        {
+            m_text.assign(text,length);
+            m_key.generation = 0UL;
+        }
+    }
+    
+    void TextLayout::setStyle(const TextStyle& style)
+    {
+        if( !sameLayout(style,m_style) )
+            m_key.generation = 0UL;
+        m_style = style;
+    }
+    
+    TextBox::TextBox(const string& text,const TextStyle& style,float rowWidth)
+    {
+        m_text = text;
+        m_style = style;
+        m_rowWidth = rowWidth;
+    }
+    
+    void TextBox::setText(const string& text)
+    {
+        setText(text.data(),text.data() + text.size());
+    }
+    
+    void TextBox::setText(const char* text,const char* end)
+    {
+        size_t length = end ? (size_t)( end - text ) : std::strlen(text);
+        if( m_text.compare(0,string::npos,text,length) != 0 )
+        {
+            m_text.assign(text,length);
+            m_key.generation = 0UL;
+        }
+    }
+    
+    void TextBox::setStyle(const TextStyle& style)
+    {
+        if( !sameLayout(style,m_style) )
+            m_key.generation = 0UL;
+        m_style = style;
+    }
+    
+    void TextBox::setRowWidth(float rowWidth)
+    {
+        if( rowWidth != m_rowWidth )
+        {
+            m_rowWidth = rowWidth;
+            m_key.generation = 0UL;
+        }
+    }
 }
-
@@ -1,9 +1,12 @@
 #ifndef TEXT_H
 #define TEXT_H
 
+class NVGcontext;
+
 namespace NanoCanvas
 {
     class Canvas;
+    class MappedFile;
     
     /**
      * @class Font
@@ -38,6 +41,17 @@ namespace NanoCanvas
          */
         Font(Canvas& canvas,const string& fname,const Memery& mem,bool invalidateMem);
         
+        /**
+         * @brief Creates font from a file mapped into memory without copying it.
+         * @param canvas The canvas who owns this font
+         * @param fname The name of the font
+         * @param file The mapped font file
+         * @note NanoVG reads the font data until its context is deleted,
+         * so the canvas keeps the mapping alive as long as the canvas
+         * @see NanoCanvas::MappedFile
+         */
+        Font(Canvas& canvas,const string& fname,const std::shared_ptr<MappedFile>& file);
+        
         /**
          * @brief Check is the font face is valid
          * @return Is the font face is valid
@@ -98,6 +112,210 @@ namespace NanoCanvas
         /// @see TextAlign::VerticalAlign
         TextAlign::VerticalAlign vAlign   = TextAlign::Baseline;
     };
+    
+    /// Number formatting description structure for Canvas::fillNumber
+    struct NumberFormat
+    {
+        /// The count of digits after the decimal point, in range [0,9]
+        int precision     = 0;
+        /// The decimal point character
+        char decimal      = '.';
+        /// The thousands separator character, 0 for no separator
+        char thousands    = 0;
+        /// Prefix positive numbers with a plus sign
+        bool plus         = false;
+        
+        /**
+         * @brief Format a number without allocating
+         * 
+         * Numbers too large for fixed notation are written in scientific notation.
+         * @param value The number to format
+         * @param buffer [out] The buffer to write the text, not null-terminated
+         * @param size The size of the buffer, 64 bytes are enough for any number
+         * @return The length of the text, 0 if the buffer is too small
+         */
+        size_t format(double value,char* buffer,size_t size)const;
+    };
+    
+    /// The font state text metrics are computed with
+    struct TextMetricsKey
+    {
+        /// The text generation of the canvas measured, 0 if not measured
+        unsigned long generation = 0UL;
+        int face          = -1;
+        float size        = 0.0f;
+        float letterSpace = 0.0f;
+        float lineHeight  = 0.0f;
+        /// The scale the glyphs are rasterized at
+        float scale       = 0.0f;
+        
+        inline bool operator==(const TextMetricsKey& key)const
+        {
+            return generation == key.generation && face == key.face && size == key.size &&
+                   letterSpace == key.letterSpace && lineHeight == key.lineHeight && scale == key.scale;
+        }
+    };
+    
+    /**
+     * @class TextLayout
+     * @brief A single line of text with its style, whose metrics are computed once
+     * 
+     * The advance width, the bounds and the glyph positions are computed by the first
+     * Canvas::measureText() or Canvas::fillText() call and reused until the text, the style,
+     * the font state the style leaves unset or the scale of the text changes.
+     * Keep a layout for each static label instead of measuring the string each frame.
+     * @code
+     * TextLayout label("Total",textStyle);
+     * float w = canvas.measureText(label);        // Laid out once
+     * canvas.fillText(label,x - w,y);             // Reuses the metrics
+     * @endcode
+     */
+    class TextLayout
+    {
+    public:
+        /// The position of a glyph relative to the origin of the text
+        struct Glyph
+        {
+            /// The byte offset of the glyph in the text
+            size_t index;
+            /// The x-coordinate of the logical glyph position
+            float x;
+            /// The left bound of the glyph shape
+            float minx;
+            /// The right bound of the glyph shape
+            float maxx;
+        };
+        
+        TextLayout() = default;
+        
+        /**
+         * @brief Create a layout of text
+         * @param text The text to lay out
+         * @param style The style to draw the text with
+         */
+        TextLayout(const string& text,const TextStyle& style);
+        
+        /// Replace the text, the metrics are invalidated if the text is changed
+        void setText(const string& text);
+        
+        /// Replace the text by a range of characters, end is nullptr if the text is null-terminated
+        void setText(const char* text,const char* end = nullptr);
+        
+        /// Replace the style, the metrics are invalidated if the font or the alignment is changed
+        void setStyle(const TextStyle& style);
+        
+        /// Get the text
+        inline const string& text()const { return m_text; }
+        
+        /// Get the text style
+        inline const TextStyle& style()const { return m_style; }
+        
+        /// Check is the metrics computed
+        inline bool measured()const { return m_key.generation != 0UL; }
+        
+        /// Get the advance width, valid once measured
+        inline float width()const { return m_width; }
+        
+        /// Get the bounds [xmin,ymin,xmax,ymax] relative to the origin, valid once measured
+        inline const float* bounds()const { return m_bounds; }
+        
+        /// Get the positions of glyphs, valid once measured
+        inline const std::vector<Glyph>& glyphs()const { return m_glyphs; }
+        
+    private:
+        friend class Canvas;
+        
+        string m_text;
+        TextStyle m_style;
+        /// The font state the metrics are computed with
+        mutable TextMetricsKey m_key;
+        mutable float m_width = 0.0f;
+        mutable float m_bounds[4] = {0.0f,0.0f,0.0f,0.0f};
+        mutable std::vector<Glyph> m_glyphs;
+    };
+    
+    /**
+     * @class TextBox
+     * @brief A text wrapped into rows of limited width, whose line breaks are computed once
+     * 
+     * The rows and the bounds are computed by the first Canvas::measureText() or Canvas::fillText()
+     * call and reused until the text, the style, the row width, the font state the style
+     * leaves unset or the scale of the text changes.
+     * Unlike the TextStyle::lineHeight of NanoVG state, a NAN line height of the style is taken as 1.
+     */
+    class TextBox
+    {
+    public:
+        /// A row of the wrapped text
+        struct Row
+        {
+            /// The byte offset of the first character of the row
+            size_t start;
+            /// The byte offset after the last visible character of the row
+            size_t end;
+            /// The logical width of the row
+            float width;
+            /// The left bound of the row shape relative to the row start
+            float minx;
+            /// The right bound of the row shape relative to the row start
+            float maxx;
+        };
+        
+        TextBox() = default;
+        
+        /**
+         * @brief Create a text box
+         * @param text The text to wrap
+         * @param style The style to draw the text with
+         * @param rowWidth The max width of rows
+         */
+        TextBox(const string& text,const TextStyle& style,float rowWidth);
+        
+        /// Replace the text, the rows are invalidated if the text is changed
+        void setText(const string& text);
+        
+        /// Replace the text by a range of characters, end is nullptr if the text is null-terminated
+        void setText(const char* text,const char* end = nullptr);
+        
+        /// Replace the style, the rows are invalidated if the font or the alignment is changed
+        void setStyle(const TextStyle& style);
+        
+        /// Set the max width of rows, the rows are invalidated if the width is changed
+        void setRowWidth(float rowWidth);
+        
+        /// Get the text
+        inline const string& text()const { return m_text; }
+        
+        /// Get the text style
+        inline const TextStyle& style()const { return m_style; }
+        
+        /// Get the max width of rows
+        inline float rowWidth()const { return m_rowWidth; }
+        
+        /// Check is the rows computed
+        inline bool measured()const { return m_key.generation != 0UL; }
+        
+        /// Get the rows, valid once measured
+        inline const std::vector<Row>& rows()const { return m_rows; }
+        
+        /// Get the distance between baselines of rows, valid once measured
+        inline float lineAdvance()const { return m_lineAdvance; }
+        
+        /// Get the bounds [xmin,ymin,xmax,ymax] relative to the origin, valid once measured
+        inline const float* bounds()const { return m_bounds; }
+        
+    private:
+        friend class Canvas;
+        
+        string m_text;
+        TextStyle m_style;
+        float m_rowWidth = 0.0f;
+        /// The font state the rows are computed with
+        mutable TextMetricsKey m_key;
+        mutable float m_lineAdvance = 0.0f;
+        mutable float m_bounds[4] = {0.0f,0.0f,0.0f,0.0f};
+        mutable std::vector<Row> m_rows;
+    };
 }
 
 #endif // TEXT_H